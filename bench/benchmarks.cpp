@@ -0,0 +1,450 @@
+#include "generators.hpp"
+#include "utils.hpp"
+#include "depth_kernels.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Benchmarks for every public solver and loader function, run over generated inputs from 1e3 items
+// up to --aoc_max_size (default 1e6, anything up to 1e9 works given the memory). All the usual Google
+// Benchmark flags apply; --benchmark_format=json or --benchmark_out=<file> give JSON results that
+// can be diffed between commits.
+
+namespace {
+
+// Field size keeping the vent line density roughly constant while the grid still fits in memory.
+int vent_field(size_t lines){
+	return static_cast<int>(std::clamp(std::sqrt(static_cast<double>(lines)) * 45.0, 1000.0, 8192.0));
+}
+
+// Generated inputs are cached, the generation itself is not part of any measurement.
+const std::string& cached_input(const std::string& kind, size_t size){
+	static std::map<std::pair<std::string, size_t>, std::string> inputs;
+	auto [it, inserted] = inputs.try_emplace({kind, size});
+	if (inserted){
+		if (kind == "depths") it->second = generate_depths(size);
+		else if (kind == "commands") it->second = generate_commands(size);
+		else if (kind == "bits") it->second = generate_bit_strings(size);
+		else if (kind == "bingo") it->second = generate_bingo(size);
+		else if (kind == "vents") it->second = generate_vent_lines(size, vent_field(size));
+	}
+	return it->second;
+}
+const std::string& cached_file(const std::string& kind, size_t size){
+	static std::map<std::pair<std::string, size_t>, std::string> paths;
+	auto [it, inserted] = paths.try_emplace({kind, size});
+	if (inserted)
+		it->second = write_temporary_input("aoc_bench_" + kind + "_" + std::to_string(size) + ".txt", cached_input(kind, size));
+	return it->second;
+}
+
+std::vector<std::string> input_lines(const std::string& kind, size_t size){
+	std::vector<std::string> lines;
+	for (std::string_view line : split_lines(cached_input(kind, size)))
+		lines.emplace_back(line);
+	return lines;
+}
+struct Bingo_Input{
+	std::vector<int> sequence;
+	std::vector<Bingo_Board> boards;
+};
+Bingo_Input bingo_input(size_t size){
+	std::istringstream stream(cached_input("bingo", size));
+	Bingo_Input input;
+	input.sequence = load_bingo_sequence(stream);
+	input.boards = load_bingo_boards(stream);
+	return input;
+}
+
+// Report throughput in items (numbers, lines, boards) and input bytes per second.
+void set_throughput(benchmark::State& state, size_t items, size_t bytes){
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * items));
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+
+template <typename Function>
+void add(const std::string& name, size_t max_size, Function function){
+	benchmark::RegisterBenchmark(name.c_str(), [function](benchmark::State& state){
+		function(state, static_cast<size_t>(state.range(0)));
+	})->RangeMultiplier(10)->Range(1000, static_cast<int64_t>(max_size))->Unit(benchmark::kMicrosecond);
+}
+
+void register_input_benchmarks(size_t max_size){
+	add("load_input<int>", max_size, [](benchmark::State& state, size_t n){
+		const std::string& path = cached_file("depths", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(load_input<int>(path));
+		set_throughput(state, n, cached_input("depths", n).size());
+	});
+	add("load_input<std::string>", max_size, [](benchmark::State& state, size_t n){
+		const std::string& path = cached_file("commands", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(load_input<std::string>(path));
+		set_throughput(state, n, cached_input("commands", n).size());
+	});
+	add("Line_Buffer", max_size, [](benchmark::State& state, size_t n){
+		const std::string& path = cached_file("commands", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(Line_Buffer(path));
+		set_throughput(state, n, cached_input("commands", n).size());
+	});
+	add("Input_File", max_size, [](benchmark::State& state, size_t n){
+		const std::string& path = cached_file("depths", n);
+		for (auto _ : state){
+			Input_File input_file(path);
+			benchmark::DoNotOptimize(input_file.contents().data());
+		}
+		set_throughput(state, n, cached_input("depths", n).size());
+	});
+	add("count_lines", max_size, [](benchmark::State& state, size_t n){
+		const std::string& text = cached_input("commands", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(count_lines(text));
+		set_throughput(state, n, text.size());
+	});
+	add("split_lines", max_size, [](benchmark::State& state, size_t n){
+		const std::string& text = cached_input("commands", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(split_lines(text));
+		set_throughput(state, n, text.size());
+	});
+	add("parse_integers<int>", max_size, [](benchmark::State& state, size_t n){
+		const std::string& text = cached_input("depths", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(parse_integers<int>(text));
+		set_throughput(state, n, text.size());
+	});
+}
+
+void register_day01_benchmarks(size_t max_size){
+	add("count_increases_simple", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<int> data = parse_integers<int>(cached_input("depths", n));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(count_increases_simple(data));
+		set_throughput(state, n, n * sizeof(int));
+	});
+	add("count_increases_sliding_window", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<int> data = parse_integers<int>(cached_input("depths", n));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(count_increases_sliding_window(data));
+		set_throughput(state, n, n * sizeof(int));
+	});
+	for (Simd_Level level : {Simd_Level::scalar, Simd_Level::sse2, Simd_Level::avx2, Simd_Level::avx512}){
+		if (static_cast<int>(level) > static_cast<int>(detect_simd_level()))
+			continue;
+		add(std::string("count_increases_at_offset/") + simd_level_name(level), max_size, [level](benchmark::State& state, size_t n){
+			const std::vector<int> data = parse_integers<int>(cached_input("depths", n));
+			for (auto _ : state)
+				benchmark::DoNotOptimize(count_increases_at_offset(data.data(), data.size(), 3, level));
+			set_throughput(state, n, n * sizeof(int));
+		});
+	}
+	// Eight widths: one pass over the series against eight separate passes.
+	add("count_window_increases/batch8", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<int> data = parse_integers<int>(cached_input("depths", n));
+		const std::vector<size_t> windows {1, 2, 3, 5, 8, 13, 21, 34};
+		for (auto _ : state)
+			benchmark::DoNotOptimize(count_window_increases(data, windows));
+		set_throughput(state, n, n * sizeof(int));
+	});
+	add("count_window_increases/separate8", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<int> data = parse_integers<int>(cached_input("depths", n));
+		for (auto _ : state)
+			for (size_t window : {1, 2, 3, 5, 8, 13, 21, 34})
+				benchmark::DoNotOptimize(count_increases_at_offset(data.data(), data.size(), window));
+		set_throughput(state, n, n * sizeof(int));
+	});
+	add("Depth_Increase_Counter::push", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<int> data = parse_integers<int>(cached_input("depths", n));
+		for (auto _ : state){
+			Depth_Increase_Counter counter;
+			counter.push(data);
+			benchmark::DoNotOptimize(counter.sliding_window_count);
+		}
+		set_throughput(state, n, n * sizeof(int));
+	});
+	add("stream_depth_measurements", max_size, [](benchmark::State& state, size_t n){
+		int fd = ::open(cached_file("depths", n).c_str(), O_RDONLY);
+		for (auto _ : state){
+			::lseek(fd, 0, SEEK_SET);
+			Depth_Increase_Counter counter;
+			stream_depth_measurements(fd, counter);
+			benchmark::DoNotOptimize(counter.sliding_window_count);
+		}
+		::close(fd);
+		set_throughput(state, n, cached_input("depths", n).size());
+	});
+}
+
+void register_day02_benchmarks(size_t max_size){
+	add("parse_submarine_command", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<std::string_view> lines = split_lines(cached_input("commands", n));
+		for (auto _ : state)
+			for (std::string_view line : lines)
+				benchmark::DoNotOptimize(parse_submarine_command(line));
+		set_throughput(state, n, cached_input("commands", n).size());
+	});
+	add("calculate_final_position", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<std::string> lines = input_lines("commands", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(calculate_final_position(lines));
+		set_throughput(state, n, cached_input("commands", n).size());
+	});
+	add("calculate_final_position_with_aim", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<std::string> lines = input_lines("commands", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(calculate_final_position_with_aim(lines));
+		set_throughput(state, n, cached_input("commands", n).size());
+	});
+	add("calculate_final_position/views", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<std::string_view> lines = split_lines(cached_input("commands", n));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(calculate_final_position(lines));
+		set_throughput(state, n, cached_input("commands", n).size());
+	});
+	add("calculate_final_positions_parallel", max_size, [](benchmark::State& state, size_t n){
+		const std::string& text = cached_input("commands", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(calculate_final_positions_parallel(text));
+		set_throughput(state, n, text.size());
+	});
+	add("combine_course_segments", max_size, [](benchmark::State& state, size_t n){
+		std::vector<Course_Segment> segments(n, Course_Segment{3, -2, 7});
+		for (auto _ : state){
+			Course_Segment total;
+			for (const Course_Segment& segment : segments)
+				total = combine_course_segments(total, segment);
+			benchmark::DoNotOptimize(total);
+		}
+		set_throughput(state, n, n * sizeof(Course_Segment));
+	});
+}
+
+void register_day03_benchmarks(size_t max_size){
+	add("binary_str_to_int", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<std::string> lines = input_lines("bits", n);
+		for (auto _ : state)
+			for (const std::string& line : lines)
+				benchmark::DoNotOptimize(binary_str_to_int(line));
+		set_throughput(state, n, cached_input("bits", n).size());
+	});
+	add("build_bit_columns", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<std::string> lines = input_lines("bits", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(build_bit_columns(lines));
+		set_throughput(state, n, cached_input("bits", n).size());
+	});
+	add("build_bit_columns/views", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<std::string_view> lines = split_lines(cached_input("bits", n));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(build_bit_columns(lines));
+		set_throughput(state, n, cached_input("bits", n).size());
+	});
+	add("most_common_bits", max_size, [](benchmark::State& state, size_t n){
+		const Bit_Columns columns = build_bit_columns(input_lines("bits", n));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(most_common_bits(columns));
+		set_throughput(state, n, columns.words.size() * sizeof(uint64_t));
+	});
+	add("calculate_gamma_epsilon_product", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<std::string> lines = input_lines("bits", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(calculate_gamma_epsilon_product(lines));
+		set_throughput(state, n, cached_input("bits", n).size());
+	});
+	add("build_sorted_index", max_size, [](benchmark::State& state, size_t n){
+		const Bit_Columns columns = build_bit_columns(input_lines("bits", n));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(build_sorted_index(columns));
+		set_throughput(state, n, columns.words.size() * sizeof(uint64_t));
+	});
+	add("find_rating", max_size, [](benchmark::State& state, size_t n){
+		const Sorted_Diagnostic_Index index = build_sorted_index(build_bit_columns(input_lines("bits", n)));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(find_rating(index, true) * find_rating(index, false));
+		set_throughput(state, n, index.values.size() * sizeof(uint64_t));
+	});
+	add("calculate_life_support_rating", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<std::string> lines = input_lines("bits", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(calculate_life_support_rating(lines));
+		set_throughput(state, n, cached_input("bits", n).size());
+	});
+}
+
+void register_day04_benchmarks(size_t max_size){
+	// Sizes are numbers of boards. The simulating functions mark the boards they are given,
+	// so those benchmarks include copying the boards in every iteration.
+	add("load_bingo_boards", max_size, [](benchmark::State& state, size_t n){
+		const std::string& text = cached_input("bingo", n);
+		for (auto _ : state){
+			std::istringstream stream(text);
+			benchmark::DoNotOptimize(load_bingo_sequence(stream));
+			benchmark::DoNotOptimize(load_bingo_boards(stream));
+		}
+		set_throughput(state, n, text.size());
+	});
+	add("Bingo_Board::mark_number", max_size, [](benchmark::State& state, size_t n){
+		const Bingo_Input input = bingo_input(n);
+		for (auto _ : state){
+			std::vector<Bingo_Board> boards = input.boards;
+			for (Bingo_Board& board : boards){
+				board.mark_number(input.sequence.front());
+				benchmark::DoNotOptimize(board.any_line_marked());
+				benchmark::DoNotOptimize(board.calculate_score(input.sequence.front()));
+			}
+		}
+		set_throughput(state, n, n * sizeof(Bingo_Board));
+	});
+	add("calculate_bingo_winner_scores/scan", max_size, [](benchmark::State& state, size_t n){
+		const Bingo_Input input = bingo_input(n);
+		for (auto _ : state){
+			std::vector<Bingo_Board> boards = input.boards;
+			benchmark::DoNotOptimize(calculate_bingo_first_winner_score(input.sequence, boards));
+			benchmark::DoNotOptimize(calculate_bingo_last_winner_score(input.sequence, boards));
+		}
+		set_throughput(state, n, n * sizeof(Bingo_Board));
+	});
+	add("build_bingo_index", max_size, [](benchmark::State& state, size_t n){
+		const Bingo_Input input = bingo_input(n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(build_bingo_index(input.boards));
+		set_throughput(state, n, n * sizeof(Bingo_Board));
+	});
+	add("calculate_bingo_winner_scores/index", max_size, [](benchmark::State& state, size_t n){
+		const Bingo_Input input = bingo_input(n);
+		const Bingo_Number_Index index = build_bingo_index(input.boards);
+		for (auto _ : state){
+			std::vector<Bingo_Board> boards = input.boards;
+			benchmark::DoNotOptimize(calculate_bingo_first_winner_score(input.sequence, boards, index));
+			benchmark::DoNotOptimize(calculate_bingo_last_winner_score(input.sequence, boards, index));
+		}
+		set_throughput(state, n, n * sizeof(Bingo_Board));
+	});
+	add("calculate_bingo_win_turn", max_size, [](benchmark::State& state, size_t n){
+		const Bingo_Input input = bingo_input(n);
+		const Bingo_Call_Table call_table = build_bingo_call_table(input.sequence);
+		for (auto _ : state)
+			for (const Bingo_Board& board : input.boards)
+				benchmark::DoNotOptimize(calculate_bingo_win_turn(board, call_table));
+		set_throughput(state, n, n * sizeof(Bingo_Board));
+	});
+	add("calculate_bingo_scores_parallel", max_size, [](benchmark::State& state, size_t n){
+		const Bingo_Input input = bingo_input(n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(calculate_bingo_scores_parallel(input.sequence, input.boards));
+		set_throughput(state, n, n * sizeof(Bingo_Board));
+	});
+	add("build_bingo_board_set", max_size, [](benchmark::State& state, size_t n){
+		const Bingo_Input input = bingo_input(n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(build_bingo_board_set(input.boards));
+		set_throughput(state, n, n * sizeof(Bingo_Board));
+	});
+	add("calculate_bingo_scores_soa", max_size, [](benchmark::State& state, size_t n){
+		const Bingo_Input input = bingo_input(n);
+		const Bingo_Board_Set board_set = build_bingo_board_set(input.boards);
+		for (auto _ : state){
+			Bingo_Board_Set boards = board_set;
+			benchmark::DoNotOptimize(calculate_bingo_scores_soa(input.sequence, boards));
+		}
+		set_throughput(state, n, board_set.values.size() * sizeof(uint16_t) + board_set.marked.size() * sizeof(uint32_t));
+	});
+}
+
+void register_day05_benchmarks(size_t max_size){
+	add("load_vent_lines", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<std::string> lines = input_lines("vents", n);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(load_vent_lines(lines));
+		set_throughput(state, n, cached_input("vents", n).size());
+	});
+	add("load_vent_lines/views", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<std::string_view> lines = split_lines(cached_input("vents", n));
+		for (auto _ : state)
+			benchmark::DoNotOptimize(load_vent_lines(lines));
+		set_throughput(state, n, cached_input("vents", n).size());
+	});
+	add("draw_lines/serial", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<Vent_Line> vent_lines = load_vent_lines(input_lines("vents", n));
+		for (auto _ : state){
+			Vent_Diagram diagram(vent_lines);
+			draw_straight_lines(vent_lines, diagram);
+			draw_diagonal_lines(vent_lines, diagram);
+			benchmark::DoNotOptimize(diagram.overlaps);
+		}
+		set_throughput(state, n, cached_input("vents", n).size());
+	});
+	add("count_overlaps", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<Vent_Line> vent_lines = load_vent_lines(input_lines("vents", n));
+		Vent_Diagram diagram(vent_lines);
+		draw_straight_lines(vent_lines, diagram);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(count_overlaps(diagram));
+		set_throughput(state, diagram.cells.size(), diagram.cells.size());
+	});
+	add("draw_lines/tiled", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<Vent_Line> vent_lines = load_vent_lines(input_lines("vents", n));
+		for (auto _ : state){
+			Vent_Diagram diagram(vent_lines);
+			benchmark::DoNotOptimize(draw_straight_lines_tiled(vent_lines, diagram));
+			benchmark::DoNotOptimize(draw_diagonal_lines_tiled(vent_lines, diagram));
+		}
+		set_throughput(state, n, cached_input("vents", n).size());
+	});
+	add("Vent_Diagram::add_line", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<Vent_Line> vent_lines = load_vent_lines(input_lines("vents", n));
+		for (auto _ : state){
+			Vent_Diagram diagram;
+			for (const Vent_Line& line : vent_lines)
+				diagram.add_line(line);
+			benchmark::DoNotOptimize(diagram.overlaps);
+		}
+		set_throughput(state, n, cached_input("vents", n).size());
+	});
+	add("count_overlaps_analytic", max_size, [](benchmark::State& state, size_t n){
+		const std::vector<Vent_Line> vent_lines = load_vent_lines(input_lines("vents", n));
+		for (auto _ : state){
+			benchmark::DoNotOptimize(count_overlaps_analytic(vent_lines, false));
+			benchmark::DoNotOptimize(count_overlaps_analytic(vent_lines, true));
+		}
+		set_throughput(state, n, cached_input("vents", n).size());
+	});
+}
+
+} // namespace
+
+int main(int argc, char** argv){
+	// Take out our own --aoc_max_size flag before Google Benchmark parses the rest.
+	size_t max_size = 1000000;
+	int kept = 1;
+	for (int i = 1; i < argc; ++i){
+		const char* prefix = "--aoc_max_size=";
+		if (std::strncmp(argv[i], prefix, std::strlen(prefix)) == 0)
+			max_size = static_cast<size_t>(std::stod(argv[i] + std::strlen(prefix)));
+		else
+			argv[kept++] = argv[i];
+	}
+	argc = kept;
+	max_size = std::max<size_t>(max_size, 1000);
+
+	register_input_benchmarks(max_size);
+	register_day01_benchmarks(max_size);
+	register_day02_benchmarks(max_size);
+	register_day03_benchmarks(max_size);
+	register_day04_benchmarks(max_size);
+	register_day05_benchmarks(max_size);
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
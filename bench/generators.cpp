@@ -0,0 +1,120 @@
+#include "generators.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+std::string generate_depths(size_t count, uint64_t seed){
+	Input_Rng rng(seed);
+	std::string text;
+	text.reserve(count * 6);
+	int64_t depth = 100;
+	for (size_t i = 0; i < count; ++i){
+		// Mostly increasing, like the puzzle input, but with enough decreases to matter.
+		depth = std::max<int64_t>(0, depth + rng.between(-15, 25));
+		text += std::to_string(depth);
+		text += '\n';
+	}
+	return text;
+}
+
+std::string generate_commands(size_t count, uint64_t seed){
+	static const char* const COMMANDS[] {"forward ", "down ", "up "};
+	Input_Rng rng(seed);
+	std::string text;
+	text.reserve(count * 9);
+	for (size_t i = 0; i < count; ++i){
+		text += COMMANDS[rng.between(0, 2)];
+		text += static_cast<char>('0' + rng.between(1, 9));
+		text += '\n';
+	}
+	return text;
+}
+
+std::string generate_bit_strings(size_t count, size_t width, uint64_t seed){
+	Input_Rng rng(seed);
+	std::string text;
+	text.reserve(count * (width + 1));
+	for (size_t i = 0; i < count; ++i){
+		uint64_t bits = 0;
+		for (size_t b = 0; b < width; ++b){
+			if (b % 64 == 0)
+				bits = rng.next();
+			text += ((bits >> (b % 64)) & 1) ? '1' : '0';
+		}
+		text += '\n';
+	}
+	return text;
+}
+
+std::string generate_bingo(size_t count, uint64_t seed){
+	Input_Rng rng(seed);
+	std::vector<int> numbers(100);
+	std::iota(numbers.begin(), numbers.end(), 0);
+
+	// Fisher-Yates shuffle of the first 'n' numbers.
+	auto shuffle_prefix = [&](size_t n){
+		for (size_t i = 0; i < n; ++i)
+			std::swap(numbers[i], numbers[static_cast<size_t>(rng.between(static_cast<int64_t>(i), 99))]);
+	};
+
+	std::string text;
+	text.reserve(300 + count * 80);
+	shuffle_prefix(100);
+	for (size_t i = 0; i < numbers.size(); ++i){
+		if (i > 0)
+			text += ',';
+		text += std::to_string(numbers[i]);
+	}
+	text += '\n';
+
+	char cell[4];
+	for (size_t board = 0; board < count; ++board){
+		text += '\n';
+		shuffle_prefix(25);
+		for (size_t i = 0; i < 25; ++i){
+			// Right aligned two-character cells separated by spaces, as in the puzzle input.
+			cell[0] = (numbers[i] < 10) ? ' ' : static_cast<char>('0' + numbers[i] / 10);
+			cell[1] = static_cast<char>('0' + numbers[i] % 10);
+			text.append(cell, 2);
+			text += (i % 5 == 4) ? '\n' : ' ';
+		}
+	}
+	return text;
+}
+
+std::string generate_vent_lines(size_t count, int field, uint64_t seed){
+	Input_Rng rng(seed);
+	std::string text;
+	text.reserve(count * 20);
+	const int64_t longest = std::max(1, field / 4);
+	for (size_t i = 0; i < count; ++i){
+		int64_t x = rng.between(0, field - 1);
+		int64_t y = rng.between(0, field - 1);
+		int64_t length = rng.between(0, longest);
+		int64_t end_x = x, end_y = y;
+		switch (rng.between(0, 3)){
+			case 0: end_x = std::min<int64_t>(field - 1, x + length); break;
+			case 1: end_y = std::min<int64_t>(field - 1, y + length); break;
+			case 2: length = std::min({length, field - 1 - x, field - 1 - y}); end_x = x + length; end_y = y + length; break;
+			case 3: length = std::min({length, field - 1 - x, y}); end_x = x + length; end_y = y - length; break;
+		}
+		// Half of the lines are written end to start, the loader has to normalize them.
+		if (rng.next() & 1){
+			std::swap(x, end_x);
+			std::swap(y, end_y);
+		}
+		text += std::to_string(x) + ',' + std::to_string(y) + " -> " + std::to_string(end_x) + ',' + std::to_string(end_y) + '\n';
+	}
+	return text;
+}
+
+std::string write_temporary_input(const std::string& name, const std::string& contents){
+	std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+	std::ofstream output(path, std::ios::binary);
+	if (!output.write(contents.data(), static_cast<std::streamsize>(contents.size())))
+		throw std::runtime_error("Failed to write temporary input file: " + path.string());
+	return path.string();
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Deterministic generators for synthetic puzzle inputs of any size.
+// Every generator produces text in exactly the format of the matching data/dayXX_input.txt,
+// and the same (size, seed) always produces the same bytes, so results can be compared between commits.
+
+// Small, fast and reproducible random number generator (splitmix64).
+struct Input_Rng{
+	uint64_t state;
+
+	explicit Input_Rng(uint64_t seed) : state(seed) {}
+	uint64_t next(){
+		uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+	// Uniform number in [low, high].
+	int64_t between(int64_t low, int64_t high){ return low + static_cast<int64_t>(next() % static_cast<uint64_t>(high - low + 1)); }
+};
+
+// Day 01: one sonar depth per line, a random walk that mostly goes deeper.
+std::string generate_depths(size_t count, uint64_t seed = 1);
+// Day 02: 'forward N', 'down N' or 'up N' per line with N in 1..9.
+std::string generate_commands(size_t count, uint64_t seed = 2);
+// Day 03: 'count' rows of 'width' random '0'/'1' characters.
+std::string generate_bit_strings(size_t count, size_t width = 12, uint64_t seed = 3);
+// Day 04: a permutation of 0..99 as the call sequence followed by 'count' boards of distinct numbers.
+std::string generate_bingo(size_t count, uint64_t seed = 4);
+// Day 05: 'count' horizontal, vertical and 45 degree lines inside a field x field square.
+std::string generate_vent_lines(size_t count, int field = 1000, uint64_t seed = 5);
+
+// Write a generated input into the temporary directory and return its path.
+std::string write_temporary_input(const std::string& name, const std::string& contents);
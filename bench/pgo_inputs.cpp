@@ -0,0 +1,70 @@
+#include "generators.hpp"
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Writes the training inputs for profile guided optimization (AOC_PGO=GENERATE, used by the pgo_train
+// target): one large generated dayXX_input.txt per day, so the instrumented dayXX executables and
+// aoc_runner can then be trained on them exactly the way they run on real inputs. The ctest checks
+// use the same inputs.
+//
+//   pgo_inputs DIR [--scale=N] [DAY]...
+//
+// --scale multiplies the default input sizes (default 1), larger values give a steadier profile and
+// fractions such as 0.1 quicker checks. DAY ("day04") restricts the output to those days.
+
+int main(int argc, char* argv[]){
+	std::filesystem::path directory;
+	double scale {1};
+	std::vector<std::string_view> days;
+	bool valid {true};
+	for (int i = 1; i < argc; ++i){
+		std::string_view argument {argv[i]};
+		if (argument.starts_with("--scale=")){
+			argument.remove_prefix(8);
+			auto [end, error] = std::from_chars(argument.data(), argument.data() + argument.size(), scale);
+			valid = valid && error == std::errc() && end == argument.data() + argument.size() && scale > 0 && scale <= 1000;
+		}
+		else if (argument.starts_with("-"))
+			valid = false;
+		else if (directory.empty())
+			directory = argument;
+		else if (argument.starts_with("day"))
+			days.push_back(argument);
+		else
+			valid = false;
+	}
+	if (!valid || directory.empty()){
+		std::cerr << "Usage: " << argv[0] << " DIR [--scale=N] [DAY]..." << std::endl;
+		return 2;
+	}
+
+	// Large enough that the hot loops dominate the profile, small enough to train in seconds.
+	auto scaled = [scale](size_t size){ return std::max<size_t>(1, static_cast<size_t>(static_cast<double>(size) * scale)); };
+	const std::pair<std::string_view, std::function<std::string()>> inputs[] {
+		{"day01", [&]{ return generate_depths(scaled(5'000'000)); }},
+		{"day02", [&]{ return generate_commands(scaled(5'000'000)); }},
+		{"day03", [&]{ return generate_bit_strings(scaled(500'000), 16); }},
+		{"day04", [&]{ return generate_bingo(scaled(10'000)); }},
+		{"day05", [&]{ return generate_vent_lines(scaled(200'000), 3000); }},
+	};
+	std::filesystem::create_directories(directory);
+	for (const auto& [day, generate] : inputs){
+		if (!days.empty() && std::find(days.begin(), days.end(), day) == days.end())
+			continue;
+		const std::filesystem::path path {directory / (std::string(day) + "_input.txt")};
+		const std::string contents {generate()};
+		std::ofstream output(path, std::ios::binary);
+		if (!output.write(contents.data(), static_cast<std::streamsize>(contents.size()))){
+			std::cerr << "Error: Failed to write " << path.string() << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,191 @@
+#include "allocation_profiler.hpp"
+#include "trace.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <mutex>
+#include <new>
+#include <sys/resource.h>
+
+// Nothing in this file may allocate with operator new while it records an allocation: the phase
+// table is a fixed array of atomics and the report is formatted into stack buffers.
+
+namespace {
+
+constexpr int MAX_PHASES = 64;
+
+struct Phase_Allocations {
+	const char* name {nullptr};
+	std::atomic<unsigned long long> allocations {0};
+	std::atomic<unsigned long long> frees {0};
+	std::atomic<unsigned long long> bytes_allocated {0};
+	std::atomic<unsigned long long> bytes_freed {0};
+	std::atomic<unsigned long long> peak_heap_bytes {0};
+	// Resident set high-water mark of the process when the phase last ended, in KiB.
+	long peak_rss_kib {0};
+};
+
+// Entry 0 collects everything outside the phases (static initialization, printing the answers, ...).
+Phase_Allocations phases[MAX_PHASES];
+std::atomic<int> phase_count {1};
+std::atomic<int> current_phase {0};
+std::atomic<unsigned long long> heap_bytes_in_use {0};
+std::mutex phase_table_mutex;
+
+void raise_to(std::atomic<unsigned long long>& peak, unsigned long long value) {
+	unsigned long long seen = peak.load(std::memory_order_relaxed);
+	while (seen < value && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+	}
+}
+
+void record_allocation(void* pointer) {
+	const unsigned long long size = malloc_usable_size(pointer);
+	Phase_Allocations& phase = phases[current_phase.load(std::memory_order_relaxed)];
+	phase.allocations.fetch_add(1, std::memory_order_relaxed);
+	phase.bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+	raise_to(phase.peak_heap_bytes, heap_bytes_in_use.fetch_add(size, std::memory_order_relaxed) + size);
+}
+
+void record_free(void* pointer) {
+	if (pointer == nullptr)
+		return;
+	const unsigned long long size = malloc_usable_size(pointer);
+	Phase_Allocations& phase = phases[current_phase.load(std::memory_order_relaxed)];
+	phase.frees.fetch_add(1, std::memory_order_relaxed);
+	phase.bytes_freed.fetch_add(size, std::memory_order_relaxed);
+	heap_bytes_in_use.fetch_sub(size, std::memory_order_relaxed);
+}
+
+long peak_rss_kib() {
+	rusage usage;
+	return (getrusage(RUSAGE_SELF, &usage) == 0) ? usage.ru_maxrss : 0;
+}
+
+void* allocate(std::size_t size, std::size_t alignment) {
+	while (true) {
+		void* pointer {nullptr};
+		if (alignment <= alignof(std::max_align_t))
+			pointer = std::malloc(size == 0 ? 1 : size);
+		else if (posix_memalign(&pointer, alignment, size == 0 ? alignment : size) != 0)
+			pointer = nullptr;
+		if (pointer != nullptr) {
+			record_allocation(pointer);
+			return pointer;
+		}
+		std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr)
+			throw std::bad_alloc();
+		handler();
+	}
+}
+
+void* allocate_nothrow(std::size_t size, std::size_t alignment) noexcept {
+	try {
+		return allocate(size, alignment);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void deallocate(void* pointer) noexcept {
+	record_free(pointer);
+	std::free(pointer);
+}
+
+void print_report() {
+	// The numbers are final here: the report runs from atexit, after main has returned.
+	phases[0].peak_rss_kib = peak_rss_kib();
+	const int count = phase_count.load();
+	const char* program = program_invocation_short_name;
+	char line[512];
+	if (active_trace_format == Trace_Format::json) {
+		std::snprintf(line, sizeof(line), "{\"program\":\"%s\",\"allocation_profile\":[", program);
+		std::fputs(line, stderr);
+		for (int i = 0; i < count; ++i) {
+			const Phase_Allocations& phase = phases[i];
+			std::snprintf(line, sizeof(line),
+				"%s{\"phase\":\"%s\",\"allocations\":%llu,\"frees\":%llu,\"bytes_allocated\":%llu,"
+				"\"net_bytes\":%lld,\"peak_heap_bytes\":%llu,\"peak_rss_kib\":%ld}",
+				i == 0 ? "" : ",", phase.name, phase.allocations.load(), phase.frees.load(), phase.bytes_allocated.load(),
+				static_cast<long long>(phase.bytes_allocated.load() - phase.bytes_freed.load()), phase.peak_heap_bytes.load(), phase.peak_rss_kib);
+			std::fputs(line, stderr);
+		}
+		std::fputs("]}\n", stderr);
+		return;
+	}
+	std::snprintf(line, sizeof(line), "[alloc] %-20s %12s %12s %16s %16s %16s %14s\n", program,
+		"allocations", "frees", "bytes", "net_bytes", "peak_heap", "peak_rss_kib");
+	std::fputs(line, stderr);
+	for (int i = 0; i < count; ++i) {
+		const Phase_Allocations& phase = phases[i];
+		std::snprintf(line, sizeof(line), "[alloc] %-20s %12llu %12llu %16llu %16lld %16llu %14ld\n", phase.name,
+			phase.allocations.load(), phase.frees.load(), phase.bytes_allocated.load(),
+			static_cast<long long>(phase.bytes_allocated.load() - phase.bytes_freed.load()), phase.peak_heap_bytes.load(), phase.peak_rss_kib);
+		std::fputs(line, stderr);
+	}
+}
+
+// Registers the report before main runs.
+[[maybe_unused]] const bool report_registered = [] {
+	phases[0].name = "(other)";
+	return std::atexit(print_report) == 0;
+}();
+
+} // namespace
+
+int enter_allocation_phase(const char* name) {
+	int index {-1};
+	{
+		std::lock_guard<std::mutex> lock(phase_table_mutex);
+		// Phases with the same name share one row, e.g. the phases of repeated runs.
+		for (int i = 1; i < phase_count.load(); ++i)
+			if (std::strcmp(phases[i].name, name) == 0)
+				index = i;
+		if (index < 0 && phase_count.load() < MAX_PHASES) {
+			index = phase_count.load();
+			phases[index].name = name;
+			phase_count.store(index + 1);
+		}
+	}
+	if (index < 0)
+		index = 0;
+	raise_to(phases[index].peak_heap_bytes, heap_bytes_in_use.load(std::memory_order_relaxed));
+	return current_phase.exchange(index);
+}
+
+void leave_allocation_phase(int previous_phase) {
+	phases[current_phase.load()].peak_rss_kib = peak_rss_kib();
+	current_phase.store(previous_phase);
+}
+
+// Replacements of every global allocation function, so no allocation escapes the accounting and
+// every pointer is released by the matching function.
+void* operator new(std::size_t size) { return allocate(size, 0); }
+void* operator new[](std::size_t size) { return allocate(size, 0); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate_nothrow(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate_nothrow(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	return allocate_nothrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	return allocate_nothrow(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { deallocate(pointer); }
@@ -0,0 +1,15 @@
+#pragma once
+
+// Heap profiler for the dayXX executables, compiled in with -DAOC_ALLOCATION_PROFILER=ON only.
+// It replaces the global operator new and delete of the process and charges every allocation, from
+// any thread, to the innermost Scoped_Phase running at the time (see trace.hpp); allocations outside
+// all phases go to "(other)". At exit it writes one row per phase to stderr: allocations, frees, bytes
+// allocated, net bytes (allocated minus freed during the phase, negative if it released earlier data),
+// the peak of heap bytes in use while it ran and the peak resident set of the process when it ended.
+// The rows are a table, or one JSON object if AOC_TRACE=json. The phases are tracked whether tracing
+// is on or not, and the tracer's own records are charged to the enclosing phase, so turning it on does
+// not change the numbers of the phases it reports.
+
+// Make 'name' the current phase. Returns the phase to restore with leave_allocation_phase.
+int enter_allocation_phase(const char* name);
+void leave_allocation_phase(int previous_phase);
@@ -0,0 +1,256 @@
+#include "input.hpp"
+#include "solver_variants.hpp"
+#include "solvers.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <charconv>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Runs any set of days over any number of input directories inside one process.
+//
+//   aoc_runner [--threads=N] [--data=DIR]... [--variant=[DAY.PART=]NAME]... [--verify] [DAY]...
+//   aoc_runner --list-variants
+//
+// DAY is a day number ("1", "01" or "day01"); without any, every implemented day runs.
+// By default every day runs its combined solver (solvers.hpp). With --variant, each part runs its
+// own implementation from the variant registry (solver_variants.hpp): the named one where given,
+// for one part (e.g. 1.2=avx2) or for every part that has a variant of that name, and the automatic
+// choice for the input and CPU otherwise ("--variant=auto" uses it everywhere). --verify runs
+// every available variant of every part and fails if any of them disagrees with the reference.
+// Each --data directory is searched for dayXX_input.txt (default: data). All inputs are loaded and
+// prefetched on a work-stealing pool, and every loaded input immediately queues its solver on the
+// same worker, so the whole batch takes about as long as its slowest day. The answers are printed
+// afterwards ordered by directory, then day, independent of which job finished first.
+
+namespace {
+
+struct Runner_Job {
+	const Day_Solver* solver {nullptr};
+	std::string path {};
+	std::unique_ptr<Input_File> input {};
+	Day_Answers answers {};
+	std::string error {};
+	// Per part: the variant that ran, or the outcome of every variant with --verify.
+	const Solver_Variant* variants[2] {nullptr, nullptr};
+	Variant_Verification verifications[2] {};
+};
+
+// A --variant choice; day and part are 0 when it applies to every part with a variant of that name.
+struct Variant_Choice {
+	int day {0};
+	int part {0};
+	std::string name;
+};
+
+enum class Variant_Mode { combined, selected, verify };
+
+int parse_day(std::string_view argument) {
+	if (argument.starts_with("day"))
+		argument.remove_prefix(3);
+	int day {0};
+	auto [end, error] = std::from_chars(argument.data(), argument.data() + argument.size(), day);
+	if (error != std::errc() || end != argument.data() + argument.size() || find_day_solver(day) == nullptr)
+		return 0;
+	return day;
+}
+
+// Parse "NAME" or "DAY.PART=NAME". Returns false for an unknown name, day or part, or an unavailable variant.
+bool parse_variant_choice(std::string_view argument, Variant_Choice& choice) {
+	if (size_t equals = argument.find('='); equals != std::string_view::npos) {
+		std::string_view target {argument.substr(0, equals)};
+		size_t dot = target.find('.');
+		if (dot == std::string_view::npos || (choice.day = parse_day(target.substr(0, dot))) == 0)
+			return false;
+		std::string_view part {target.substr(dot + 1)};
+		if (part != "1" && part != "2")
+			return false;
+		choice.part = part[0] - '0';
+		choice.name = argument.substr(equals + 1);
+		const Solver_Variant* variant = find_solver_variant(choice.day, choice.part, choice.name);
+		return variant != nullptr && variant->available();
+	}
+	choice.name = argument;
+	if (choice.name == "auto")
+		return true;
+	for (const Solver_Variant& variant : solver_variants())
+		if (choice.name == variant.name && variant.available())
+			return true;
+	return false;
+}
+
+// Variant that runs a part: a choice for exactly this part first, then a name given for all parts,
+// then the automatic selection.
+const Solver_Variant* choose_variant(const std::vector<Variant_Choice>& choices, int day, int part, std::string_view input) {
+	for (const Variant_Choice& choice : choices)
+		if (choice.day == day && choice.part == part)
+			return find_solver_variant(day, part, choice.name);
+	for (const Variant_Choice& choice : choices)
+		if (choice.day == 0)
+			if (const Solver_Variant* variant = find_solver_variant(day, part, choice.name); variant != nullptr && variant->available())
+				return variant;
+	return &select_solver_variant(day, part, input);
+}
+
+void list_variants() {
+	for (const Day_Solver& solver : day_solvers()) {
+		for (int part = 1; part <= 2; ++part) {
+			std::cout << solver.name << " part " << part << ":";
+			for (const Solver_Variant* variant : find_solver_variants(solver.day, part)) {
+				std::cout << " " << variant->name;
+				if (!variant->available())
+					std::cout << " (unsupported)";
+				else if (variant->min_input_size > 0)
+					std::cout << " (auto from " << (variant->min_input_size >> 20) << " MiB)";
+			}
+			std::cout << std::endl;
+		}
+	}
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	configure_trace(argc, argv);
+
+	unsigned thread_count {0};
+	std::vector<std::string> directories;
+	std::vector<const Day_Solver*> selected;
+	std::vector<Variant_Choice> variant_choices;
+	Variant_Mode mode {Variant_Mode::combined};
+	for (int i = 1; i < argc; ++i) {
+		std::string_view argument {argv[i]};
+		if (argument.starts_with("--threads=")) {
+			argument.remove_prefix(10);
+			auto [end, error] = std::from_chars(argument.data(), argument.data() + argument.size(), thread_count);
+			if (error != std::errc() || end != argument.data() + argument.size()) {
+				std::cerr << "Error: Invalid thread count '" << argument << "'" << std::endl;
+				return 2;
+			}
+		}
+		else if (argument.starts_with("--data="))
+			directories.emplace_back(argument.substr(7));
+		else if (argument.starts_with("--variant=")) {
+			Variant_Choice choice;
+			if (!parse_variant_choice(argument.substr(10), choice)) {
+				std::cerr << "Error: Unknown or unsupported variant '" << argument.substr(10) << "', see --list-variants" << std::endl;
+				return 2;
+			}
+			variant_choices.push_back(choice);
+			if (mode == Variant_Mode::combined)
+				mode = Variant_Mode::selected;
+		}
+		else if (argument == "--verify")
+			mode = Variant_Mode::verify;
+		else if (argument == "--list-variants") {
+			list_variants();
+			return 0;
+		}
+		else if (int day = parse_day(argument); day != 0) {
+			if (std::find(selected.begin(), selected.end(), find_day_solver(day)) == selected.end())
+				selected.push_back(find_day_solver(day));
+		}
+		else {
+			std::cerr << "Error: Unknown argument or day '" << argument << "'" << std::endl;
+			std::cerr << "Usage: " << argv[0] << " [--threads=N] [--data=DIR]... [--variant=[DAY.PART=]NAME]... [--verify] [DAY]..." << std::endl;
+			return 2;
+		}
+	}
+	if (directories.empty())
+		directories.emplace_back("data");
+	if (selected.empty())
+		for (const Day_Solver& solver : day_solvers())
+			selected.push_back(&solver);
+	std::sort(selected.begin(), selected.end(), [](const Day_Solver* a, const Day_Solver* b) { return a->day < b->day; });
+
+	std::vector<Runner_Job> jobs;
+	for (const std::string& directory : directories)
+		for (const Day_Solver* solver : selected) {
+			Runner_Job& job = jobs.emplace_back();
+			job.solver = solver;
+			job.path = directory + "/" + solver->name + "_input.txt";
+		}
+
+	{
+		Scoped_Phase phase("run_all");
+		Work_Stealing_Pool pool(thread_count);
+		// Split the cores between the jobs, so the solvers that start threads of their own do not
+		// oversubscribe the machine when many jobs run at once.
+		const unsigned solver_threads = std::max<unsigned>(1, pool.thread_count() / static_cast<unsigned>(jobs.size()));
+		for (Runner_Job& job : jobs) {
+			pool.submit([&pool, &job, &variant_choices, mode, solver_threads] {
+				try {
+					job.input = std::make_unique<Input_File>(job.path);
+					job.input->prefetch();
+				} catch (const std::exception& exception) {
+					job.error = exception.what();
+					return;
+				}
+				// Queued on this worker's own deque: it runs next here while the input is hot in cache,
+				// unless an idle worker steals it first.
+				pool.submit([&job, &variant_choices, mode, solver_threads] {
+					try {
+						const std::string_view input {job.input->contents()};
+						if (mode == Variant_Mode::combined)
+							job.answers = job.solver->solve(input, solver_threads);
+						else if (count_lines(input) == 0)
+							job.error = "Error: No data loaded.";
+						else if (mode == Variant_Mode::selected) {
+							job.variants[0] = choose_variant(variant_choices, job.solver->day, 1, input);
+							job.variants[1] = choose_variant(variant_choices, job.solver->day, 2, input);
+							job.answers = {job.variants[0]->solve(input, solver_threads), job.variants[1]->solve(input, solver_threads)};
+						}
+						else {
+							job.verifications[0] = verify_solver_variants(job.solver->day, 1, input, solver_threads);
+							job.verifications[1] = verify_solver_variants(job.solver->day, 2, input, solver_threads);
+						}
+					} catch (const std::exception& exception) {
+						job.error = exception.what();
+					}
+					job.input.reset();
+				});
+			});
+		}
+		pool.wait_idle();
+	}
+
+	int exit_code {0};
+	for (const Runner_Job& job : jobs) {
+		std::cout << job.solver->name << " (" << job.path << ")" << std::endl;
+		if (!job.error.empty()) {
+			std::cout << job.error << std::endl;
+			exit_code = 1;
+			continue;
+		}
+		if (mode == Variant_Mode::verify) {
+			for (int part = 1; part <= 2; ++part) {
+				const Variant_Verification& verification = job.verifications[part - 1];
+				if (verification.agree) {
+					std::cout << "Part " << part << ": " << verification.results.front().answer << " ("
+						<< verification.results.size() << " variants agree)" << std::endl;
+					continue;
+				}
+				// Every answer is shown on a mismatch, so the odd one out is obvious.
+				std::cout << "Part " << part << ": MISMATCH" << std::endl;
+				for (const Variant_Result& result : verification.results)
+					std::cout << "  " << result.variant->name << ": " << (result.error.empty() ? result.answer : result.error) << std::endl;
+				exit_code = 1;
+			}
+			continue;
+		}
+		std::cout << "Part 1: " << job.answers.part1;
+		if (job.variants[0] != nullptr)
+			std::cout << " [" << job.variants[0]->name << "]";
+		std::cout << std::endl;
+		std::cout << "Part 2: " << job.answers.part2;
+		if (job.variants[1] != nullptr)
+			std::cout << " [" << job.variants[1]->name << "]";
+		std::cout << std::endl;
+	}
+	return exit_code;
+}
@@ -0,0 +1,207 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// constexpr versions of the day 01 to 03 solvers.
+// They work on spans and string views instead of loaded containers, so they can run at compile
+// time over inputs embedded into the binary (see AOC_EMBED_INPUTS in CMakeLists.txt) as well as at
+// runtime. They follow the runtime solvers in utils.hpp, including the errors they throw; an invalid
+// embedded input therefore fails the build instead of producing a wrong answer.
+// The runtime versions remain the fast path: they use SIMD kernels, threads and std::from_chars.
+
+namespace constexpr_detail {
+
+constexpr bool is_space(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+// Next line of 'text' starting at 'position' with std::getline semantics, 'position' moves past it.
+constexpr std::string_view next_line(std::string_view text, size_t& position) {
+	size_t newline = text.find('\n', position);
+	if (newline == std::string_view::npos)
+		newline = text.size();
+	std::string_view line = text.substr(position, newline - position);
+	position = (newline == text.size()) ? newline : newline + 1;
+	return line;
+}
+
+// Parse a decimal integer starting at 'position' (an optional sign included) and move past it.
+// Returns false without moving if there is no number at 'position'.
+constexpr bool parse_integer(std::string_view text, size_t& position, long long& value) {
+	size_t current = position;
+	bool negative = false;
+	if (current < text.size() && (text[current] == '-' || text[current] == '+'))
+		negative = (text[current++] == '-');
+	if (current == text.size() || text[current] < '0' || text[current] > '9')
+		return false;
+	value = 0;
+	while (current < text.size() && text[current] >= '0' && text[current] <= '9')
+		value = value * 10 + (text[current++] - '0');
+	if (negative)
+		value = -value;
+	position = current;
+	return true;
+}
+
+} // namespace constexpr_detail
+
+// Day 01 specific utility functions.
+
+// Parse whitespace separated integers, stopping quietly at the first token that is not an integer
+// (like parse_integers in input.hpp).
+constexpr std::vector<int> parse_depths(std::string_view text) {
+	std::vector<int> values;
+	size_t position = 0;
+	while (true) {
+		while (position < text.size() && constexpr_detail::is_space(text[position]))
+			++position;
+		long long value = 0;
+		// A leading '-' only belongs to the number if a digit follows, otherwise parsing stops here.
+		if (position == text.size() || !constexpr_detail::parse_integer(text, position, value))
+			break;
+		values.push_back(static_cast<int>(value));
+	}
+	return values;
+}
+
+constexpr int count_increases_simple(std::span<const int> data) {
+	int count = 0;
+	for (size_t i = 1; i < data.size(); ++i)
+		count += (data[i - 1] < data[i]);
+	return count;
+}
+
+// The two middle measurements are shared by neighbouring windows, so comparing data[i] with data[i + 3] suffices.
+constexpr int count_increases_sliding_window(std::span<const int> data) {
+	int count = 0;
+	for (size_t i = 3; i < data.size(); ++i)
+		count += (data[i - 3] < data[i]);
+	return count;
+}
+
+// Day 02 specific utility functions.
+
+// Sum up one command log in a single pass; 'with_aim' selects the part 2 rules.
+// Throws std::runtime_error for unknown commands and missing values, like parse_submarine_command.
+constexpr long long calculate_course_product(std::string_view commands, bool with_aim) {
+	long long x {0}, y {0}, aim {0};
+	size_t position = 0;
+	while (position < commands.size()) {
+		std::string_view line = constexpr_detail::next_line(commands, position);
+		size_t current = 0;
+		while (current < line.size() && constexpr_detail::is_space(line[current]))
+			++current;
+		size_t word_end = current;
+		while (word_end < line.size() && !constexpr_detail::is_space(line[word_end]))
+			++word_end;
+		std::string_view keyword = line.substr(current, word_end - current);
+
+		current = word_end;
+		while (current < line.size() && constexpr_detail::is_space(line[current]))
+			++current;
+		long long value = 0;
+		if (keyword.empty() || !constexpr_detail::parse_integer(line, current, value))
+			throw std::runtime_error("Error: invalid input line: " + std::string(line));
+		const long long step = value;
+
+		if (keyword == "forward") {
+			x += step;
+			y += aim * step;
+		}
+		else if (keyword == "down")
+			aim += step;
+		else if (keyword == "up")
+			aim -= step;
+		else
+			throw std::runtime_error("Error: unknown command: " + std::string(keyword));
+	}
+	// Without aim the depth is exactly what the aim accumulates.
+	return with_aim ? x * y : x * aim;
+}
+
+constexpr long long calculate_final_position(std::string_view commands) {
+	return calculate_course_product(commands, false);
+}
+
+constexpr long long calculate_final_position_with_aim(std::string_view commands) {
+	return calculate_course_product(commands, true);
+}
+
+// Day 03 specific utility functions.
+
+// Product of the gamma and epsilon rates of a diagnostic report given as text, one row per line.
+// Throws std::runtime_error for rows of different width and std::overflow_error beyond 64 bits.
+constexpr unsigned long long calculate_gamma_epsilon_product(std::string_view report) {
+	size_t ones[64] {};
+	size_t rows = 0, width = 0;
+	size_t position = 0;
+	while (position < report.size()) {
+		std::string_view row = constexpr_detail::next_line(report, position);
+		if (rows == 0) {
+			width = row.size();
+			if (width > 64)
+				throw std::overflow_error("Error: gamma and epsilon rates do not fit in 64 bits");
+		}
+		if (row.size() != width)
+			throw std::runtime_error("Error: diagnostic row has a different width: " + std::string(row));
+		for (size_t i = 0; i < width; ++i)
+			ones[i] += (row[i] == '1');
+		++rows;
+	}
+
+	unsigned long long gamma = 0, epsilon = 0;
+	for (size_t i = 0; i < width; ++i) {
+		bool most_common_is_one = (ones[i] > rows / 2);
+		gamma = (gamma << 1) | (most_common_is_one ? 1ULL : 0ULL);
+		epsilon = (epsilon << 1) | (most_common_is_one ? 0ULL : 1ULL);
+	}
+	return gamma * epsilon;
+}
+
+// Product of the oxygen generator and CO2 scrubber ratings, filtered over the sorted rows exactly
+// like find_rating does. Also part of the compile-time mode so day03 needs no runtime solving at all.
+constexpr unsigned long long calculate_life_support_rating(std::string_view report) {
+	std::vector<unsigned long long> values;
+	size_t width = 0;
+	size_t position = 0;
+	while (position < report.size()) {
+		std::string_view row = constexpr_detail::next_line(report, position);
+		if (values.empty()) {
+			width = row.size();
+			if (width > 64)
+				throw std::overflow_error("Error: diagnostic rows do not fit in 64 bits");
+		}
+		if (row.size() != width)
+			throw std::runtime_error("Error: diagnostic row has a different width: " + std::string(row));
+		unsigned long long value = 0;
+		for (char bit : row)
+			value = (value << 1) | (bit == '1' ? 1ULL : 0ULL);
+		values.push_back(value);
+	}
+	if (values.empty())
+		throw std::runtime_error("Error: no diagnostic rows to rate");
+	std::sort(values.begin(), values.end());
+
+	auto rating = [&](bool keep_most_common) {
+		auto first = values.begin();
+		auto last = values.end();
+		for (size_t pos = 0; pos < width && last - first > 1; ++pos) {
+			const unsigned long long mask = 1ULL << (width - 1 - pos);
+			auto first_one = std::partition_point(first, last, [mask](unsigned long long value) { return (value & mask) == 0; });
+			auto ones = last - first_one;
+			auto zeros = first_one - first;
+			bool keep_one = keep_most_common ? (ones >= zeros) : (zeros > ones);
+			if (ones == 0 || zeros == 0)
+				keep_one = (ones != 0);
+			if (keep_one)
+				first = first_one;
+			else
+				last = first_one;
+		}
+		return *first;
+	};
+	return rating(true) * rating(false);
+}
@@ -1,19 +1,95 @@
 #include "utils.hpp"
+#include "trace.hpp"
+#include "input_cache.hpp"
+#ifdef AOC_EMBEDDED_INPUT
+#include "constexpr_solvers.hpp"
+#include "embedded_input.hpp"
+#endif
 #include <iostream>
 #include <vector>
+#include <string_view>
+#include <unistd.h>
+#include <charconv>
 
-int main(){
-	// Load data from the input file into a vector for processing.
+// Count the increases of sliding windows of every width in 'list' ("K[,K...]") over the input file.
+// Returns the exit code: 2 for an invalid list, 1 if no data could be loaded.
+static int print_window_increases(std::string_view list){
+	const std::string_view full_list {list};
+	std::vector<size_t> windows;
+	while(true){
+		size_t window {0};
+		auto [end, error] = std::from_chars(list.data(), list.data() + list.size(), window);
+		if(error != std::errc() || window == 0 || (end != list.data() + list.size() && *end != ',')){
+			std::cerr << "Error: Invalid window list '" << full_list << "', expected widths like 1,3,10" << std::endl;
+			return 2;
+		}
+		windows.push_back(window);
+		if(end == list.data() + list.size())
+			break;
+		list.remove_prefix(static_cast<size_t>(end - list.data()) + 1);
+	}
+
+	std::vector<int> data {trace_phase("load", []{ return load_input<int>("data/day01_input.txt"); })};
+	if(data.empty()){
+		std::cout << "No data loaded." << std::endl;
+		return 1;
+	}
+	std::vector<unsigned long long> counts {trace_phase("windows", [&]{ return count_window_increases(data, windows); })};
+	for(size_t i = 0; i < windows.size(); ++i)
+		std::cout << "Window " << windows[i] << ": " << counts[i] << std::endl;
+	return 0;
+}
+
+int main(int argc, char* argv[]){
+	// AOC_TRACE=text|json or --trace[=json] reports the time and hardware counters of every phase on stderr.
+	configure_trace(argc, argv);
+
+	// '--windows=K[,K...]' answers the sliding window question for every given width in one pass
+	// over the measurements, instead of solving the two parts.
+	if(argc > 1 && std::string_view(argv[1]).starts_with("--windows="))
+		return print_window_increases(std::string_view(argv[1]).substr(10));
+
+	// Passing '-' as the only argument streams the measurements from stdin in constant memory
+	// instead of loading the whole input file.
+	if(argc > 1 && std::string_view(argv[1]) == "-"){
+		Depth_Increase_Counter counter;
+		trace_phase("stream", [&]{ stream_depth_measurements(STDIN_FILENO, counter); });
+		std::cout << "Part 1: " << counter.simple_count << std::endl;
+		std::cout << "Part 2: " << counter.sliding_window_count << std::endl;
+		return 0;
+	}
+
+#ifdef AOC_EMBEDDED_INPUT
+	// Built with AOC_EMBED_INPUTS: the input is compiled into the binary and the compiler already
+	// computed both answers, so nothing is read or solved at startup.
+	if(EMBEDDED_INPUT.empty()){
+		std::cout << "No data loaded." << std::endl;
+		return 1;
+	}
+	constexpr int part1 = []{ std::vector<int> data {parse_depths(EMBEDDED_INPUT)}; return count_increases_simple(std::span<const int>(data)); }();
+	constexpr int part2 = []{ std::vector<int> data {parse_depths(EMBEDDED_INPUT)}; return count_increases_sliding_window(std::span<const int>(data)); }();
+	std::cout << "Part 1: " << part1 << std::endl;
+	std::cout << "Part 2: " << part2 << std::endl;
+	return 0;
+#endif
+
+	// Load the measurements from the input file, or map them from its binary cache (AOC_INPUT_CACHE=1).
 	// If the file is not found, cannot be opened, or contains no data an error message is printed
 	// and the program returns with a non-zero exit code.
-	std::vector<int> data {load_input<int>("data/day01_input.txt")};
+	Parsed_Input parsed {trace_phase("load", []{
+		return load_parsed_input("data/day01_input.txt", Input_Cache_Kind::depths, [](std::string_view contents){
+			return Parsed_Input({make_input_section(parse_integers<int>(contents))});
+		});
+	})};
+	std::span<const int> data {parsed.section<int>(0)};
 	if(data.empty()){
 		std::cout << "No data loaded." << std::endl;
 		return 1;
 	}
 
-	std::cout << "Part 1: " << count_increases_simple(data) << std::endl;
-	std::cout << "Part 2: " << count_increases_sliding_window(data) << std::endl;
+	// Both parts are sliding windows, of one and of three measurements, counted on all cores.
+	std::cout << "Part 1: " << trace_phase("part1", [&]{ return count_window_increases(data, 1); }) << std::endl;
+	std::cout << "Part 2: " << trace_phase("part2", [&]{ return count_window_increases(data, 3); }) << std::endl;
 	
 	return 0;
 }
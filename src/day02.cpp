@@ -1,20 +1,61 @@
 #include "utils.hpp"
+#include "trace.hpp"
+#include "input_cache.hpp"
+#ifdef AOC_EMBEDDED_INPUT
+#include "constexpr_solvers.hpp"
+#include "embedded_input.hpp"
+#endif
 #include <iostream>
-#include <vector>
-#include <string>
 
-int main(){
-	// Load data from the input file into a vector for processing.
-	// If the file is not found, cannot be opened, or contains no data an error message is printed
-	// and the program returns with a non-zero exit code.
-	std::vector<std::string> data {load_input<std::string>("data/day02_input.txt")};
-	if(data.empty()){
+int main(int argc, char* argv[]){
+	// AOC_TRACE=text|json or --trace[=json] reports the time and hardware counters of every phase on stderr.
+	configure_trace(argc, argv);
+
+#ifdef AOC_EMBEDDED_INPUT
+	// Built with AOC_EMBED_INPUTS: the input is compiled into the binary and the compiler already
+	// computed both answers, so nothing is read or solved at startup.
+	if(EMBEDDED_INPUT.empty()){
 		std::cout << "No data loaded." << std::endl;
 		return 1;
 	}
-	
-	std::cout << "Part 1: " << calculate_final_position(data) << std::endl;
-	std::cout << "Part 2: " << calculate_final_position_with_aim(data) << std::endl;
+	constexpr long long part1 = calculate_final_position(EMBEDDED_INPUT);
+	constexpr long long part2 = calculate_final_position_with_aim(EMBEDDED_INPUT);
+	std::cout << "Part 1: " << part1 << std::endl;
+	std::cout << "Part 2: " << part2 << std::endl;
+	return 0;
+#endif
+
+	// With AOC_INPUT_CACHE=1 the parsed commands are cached and reloaded, a run over the cache only
+	// sums them up. Otherwise the input file is mapped and both parts are solved in one parallel
+	// pass over the raw commands, which beats parsing into an array first.
+	// If the file is not found, cannot be opened, or contains no data an error message is printed
+	// and the program returns with a non-zero exit code.
+	Course_Result result;
+	if(input_cache_enabled()){
+		Parsed_Input parsed {trace_phase("load", []{
+			return load_parsed_input("data/day02_input.txt", Input_Cache_Kind::commands, [](std::string_view contents){
+				std::vector<Submarine_Command> commands;
+				for (std::string_view line : split_lines(contents))
+					commands.push_back(parse_submarine_command(line));
+				return Parsed_Input({make_input_section(std::move(commands))});
+			});
+		})};
+		if(parsed.section<Submarine_Command>(0).empty()){
+			std::cout << "No data loaded." << std::endl;
+			return 1;
+		}
+		result = trace_phase("solve", [&]{ return calculate_final_positions(parsed.section<Submarine_Command>(0)); });
+	}
+	else{
+		Input_File input_file {trace_phase("load", []{ return Input_File("data/day02_input.txt"); })};
+		if(count_lines(input_file.contents()) == 0){
+			std::cout << "No data loaded." << std::endl;
+			return 1;
+		}
+		result = trace_phase("solve", [&]{ return calculate_final_positions_parallel(input_file.contents()); });
+	}
+	std::cout << "Part 1: " << result.final_position << std::endl;
+	std::cout << "Part 2: " << result.final_position_with_aim << std::endl;
 	
 	return 0;
 }
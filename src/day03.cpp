@@ -1,20 +1,61 @@
 #include "utils.hpp"
+#include "trace.hpp"
+#include "input_cache.hpp"
+#ifdef AOC_EMBEDDED_INPUT
+#include "constexpr_solvers.hpp"
+#include "embedded_input.hpp"
+#endif
 #include <iostream>
-#include <string>
-#include <vector>
 
-int main(){
-	// Load data from the input file into a vector for processing.
+int main(int argc, char* argv[]){
+	// AOC_TRACE=text|json or --trace[=json] reports the time and hardware counters of every phase on stderr.
+	configure_trace(argc, argv);
+
+#ifdef AOC_EMBEDDED_INPUT
+	// Built with AOC_EMBED_INPUTS: the input is compiled into the binary and the compiler already
+	// computed both answers, so nothing is read or solved at startup.
+	if(EMBEDDED_INPUT.empty()){
+		std::cout << "No data loaded." << std::endl;
+		return 1;
+	}
+	constexpr unsigned long long part1 = calculate_gamma_epsilon_product(EMBEDDED_INPUT);
+	constexpr unsigned long long part2 = calculate_life_support_rating(EMBEDDED_INPUT);
+	std::cout << "Part 1: " << part1 << std::endl;
+	std::cout << "Part 2: " << part2 << std::endl;
+	return 0;
+#endif
+
 	// If the file is not found, cannot be opened, or contains no data an error message is printed
 	// and the program returns with a non-zero exit code.
-	std::vector<std::string> data {load_input<std::string>("data/day03_input.txt")};
+	if(input_cache_enabled()){
+		// With AOC_INPUT_CACHE=1 the rows are packed into sorted integers and cached, a run over the
+		// cache maps them without parsing. The cache parameter holds the row width.
+		Parsed_Input parsed {trace_phase("load", []{
+			return load_parsed_input("data/day03_input.txt", Input_Cache_Kind::diagnostic_rows, [](std::string_view contents){
+				std::vector<std::string_view> lines {split_lines(contents)};
+				Sorted_Diagnostic_Index index {build_sorted_index(build_bit_columns(lines))};
+				return Parsed_Input({make_input_section(std::move(index.values))}, index.width);
+			});
+		})};
+		std::span<const uint64_t> rows {parsed.section<uint64_t>(0)};
+		if(rows.empty()){
+			std::cout << "No data loaded." << std::endl;
+			return 1;
+		}
+		std::cout << "Part 1: " << trace_phase("part1", [&]{ return calculate_gamma_epsilon_product(rows, parsed.parameter()); }) << std::endl;
+		std::cout << "Part 2: " << trace_phase("part2", [&]{ return calculate_life_support_rating(rows, parsed.parameter()); }) << std::endl;
+		return 0;
+	}
+
+	// Load the input file into one buffer and view its lines without copying them.
+	Line_Buffer data {trace_phase("load", []{ return Line_Buffer("data/day03_input.txt"); })};
 	if(data.empty()){
 		std::cout << "No data loaded." << std::endl;
 		return 1;
 	}
 
-	std::cout << "Part 1: " << calculate_gamma_epsilon_product(data) << std::endl;
-	std::cout << "Part 2: " << calculate_life_support_rating(data) << std::endl;
+	std::cout << "Part 1: " << trace_phase("part1", [&]{ return calculate_gamma_epsilon_product(data.lines()); }) << std::endl;
+	std::cout << "Part 2: " << trace_phase("part2", [&]{ return calculate_life_support_rating(data.lines()); }) << std::endl;
 
 	return 0;
 }
@@ -1,14 +1,38 @@
 #include "utils.hpp"
+#include "trace.hpp"
+#include "input_cache.hpp"
 #include <iostream>
+#include <sstream>
 
-int main()
+int main(int argc, char* argv[])
 {	
-	auto file_stream = std::ifstream("data/day04_input.txt");
-	std::vector<int> bingo_sequence = load_bingo_sequence(file_stream);
-	std::vector<Bingo_Board> boards = load_bingo_boards(file_stream);
-	
-	std::cout << "Part 1: " << calculate_bingo_first_winner_score(bingo_sequence, boards) << std::endl;
-	std::cout << "Part 2: " << calculate_bingo_last_winner_score(bingo_sequence, boards) << std::endl;
+	// AOC_TRACE=text|json or --trace[=json] reports the time and hardware counters of every phase on stderr.
+	configure_trace(argc, argv);
+
+	// Both parts come from the win turns of the boards, the boards are left untouched. Part 2 is
+	// therefore scored on fresh boards: it is the last board to win over the whole sequence, not a
+	// replay on the boards Part 1 had already marked, where the Part 1 winner won again on the first
+	// call whenever it was the only board to win or not every board won.
+	Bingo_Results results;
+	if(input_cache_enabled()){
+		// Section 0 holds the called numbers, section 1 the boards; both are mapped from the binary
+		// cache of the input instead of being parsed again.
+		Parsed_Input parsed {trace_phase("load", []{
+			return load_parsed_input("data/day04_input.txt", Input_Cache_Kind::bingo, [](std::string_view contents){
+				std::istringstream input_stream {std::string(contents)};
+				std::vector<int> bingo_sequence {load_bingo_sequence(input_stream)};
+				std::vector<Bingo_Board> boards {load_bingo_boards(input_stream)};
+				return Parsed_Input({make_input_section(std::move(bingo_sequence)), make_input_section(std::move(boards))});
+			});
+		})};
+		results = trace_phase("solve", [&]{ return calculate_bingo_scores_parallel(parsed.section<int>(0), parsed.section<Bingo_Board>(1)); });
+	}
+	else{
+		// Reading, parsing and evaluating the boards overlap, batch by batch.
+		results = trace_phase("load_and_solve", []{ return calculate_bingo_scores_pipelined("data/day04_input.txt"); });
+	}
+	std::cout << "Part 1: " << results.first_winner_score << std::endl;
+	std::cout << "Part 2: " << results.last_winner_score << std::endl;
 	
 	return 0;
 }
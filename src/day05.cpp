@@ -1,20 +1,62 @@
 #include "utils.hpp"
+#include "trace.hpp"
+#include "input_cache.hpp"
+#include <array>
 #include <iostream>
 
-int main()
+int main(int argc, char* argv[])
 {
-    std::vector<std::string> data {load_input<std::string>("data/day05_input.txt")};
-	if(data.empty()){
+    // AOC_TRACE=text|json or --trace[=json] reports the time and hardware counters of every phase on stderr.
+    configure_trace(argc, argv);
+
+    if(!input_cache_enabled()){
+        // The file is read and parsed block by block on separate threads, then the lines are drawn
+        // tile by tile on all cores.
+        Vent_Overlaps overlaps {trace_phase("load_and_solve", []{ return calculate_vent_overlaps_pipelined("data/day05_input.txt"); })};
+        if(overlaps.line_count == 0){
+            std::cout << "No data loaded." << std::endl;
+            return 1;
+        }
+        std::cout << "Part 1: " << overlaps.straight << std::endl;
+        std::cout << "Part 2: " << overlaps.all << std::endl;
+        return 0;
+    }
+
+    // With AOC_INPUT_CACHE=1 the endpoints (x1, y1, x2, y2) of the lines are cached, Vent_Line itself
+    // is not trivially copyable.
+    Parsed_Input parsed {trace_phase("load", []{
+        return load_parsed_input("data/day05_input.txt", Input_Cache_Kind::vent_lines, [](std::string_view contents){
+            std::vector<std::array<int, 4>> endpoints;
+            for (const Vent_Line& line : load_vent_lines(split_lines(contents)))
+                endpoints.push_back({line.start_point.first, line.start_point.second, line.end_point.first, line.end_point.second});
+            return Parsed_Input({make_input_section(std::move(endpoints))});
+        });
+    })};
+	if(parsed.section<std::array<int, 4>>(0).empty()){
 		std::cout << "No data loaded." << std::endl;
 		return 1;
 	}
-    std::vector<Vent_Line> vent_lines = load_vent_lines(data);
+    std::vector<Vent_Line> vent_lines = trace_phase("build_lines", [&]{
+        std::vector<Vent_Line> lines;
+        lines.reserve(parsed.section<std::array<int, 4>>(0).size());
+        for (const std::array<int, 4>& points : parsed.section<std::array<int, 4>>(0))
+            lines.emplace_back(std::make_pair(points[0], points[1]), std::make_pair(points[2], points[3]));
+        return lines;
+    });
+
+    // Lines spread over too large a range to rasterize are counted without a diagram.
+    if(!vent_diagram_fits(vent_lines)){
+        std::cout << "Part 1: " << trace_phase("part1", [&]{ return count_overlaps_analytic(vent_lines, false); }) << std::endl;
+        std::cout << "Part 2: " << trace_phase("part2", [&]{ return count_overlaps_analytic(vent_lines, true); }) << std::endl;
+        return 0;
+    }
 
-    std::array<std::array<int, ARRSIZE>, ARRSIZE> diagram{};
-	draw_straight_lines(vent_lines, diagram);
-	std::cout << "Part 1: " << count_overlaps(diagram) << std::endl;
-	draw_diagonal_lines(vent_lines, diagram);
-	std::cout << "Part 2: " << count_overlaps(diagram) << std::endl;
+    // The diagram covers just the bounding box of the lines and lives on the heap.
+    Vent_Diagram diagram {trace_phase("allocate", [&]{ return Vent_Diagram(vent_lines); })};
+	// Lines are drawn tile by tile on all cores. The diagram tallies its overlaps while drawing,
+	// so each call just returns the running count instead of rescanning the grid.
+	std::cout << "Part 1: " << trace_phase("part1", [&]{ return draw_straight_lines_tiled(vent_lines, diagram); }) << std::endl;
+	std::cout << "Part 2: " << trace_phase("part2", [&]{ return draw_diagonal_lines_tiled(vent_lines, diagram); }) << std::endl;
 
     return 0;
-}
\ No newline at end of file
+}
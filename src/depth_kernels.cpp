@@ -0,0 +1,154 @@
+#include "depth_kernels.hpp"
+#include <stdexcept>
+#include <string>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define AOC_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Reference implementation, also used for the tails the vector loops leave over.
+unsigned long long count_scalar(const int* data, size_t size, size_t offset) {
+	unsigned long long count {0};
+	for (size_t i = 0; i + offset < size; ++i)
+		count += (data[i] < data[i + offset]);
+	return count;
+}
+
+#ifdef AOC_X86_KERNELS
+// The vector kernels keep one 32-bit counter per lane and flush them into a 64-bit total after
+// at most BLOCKSIZE iterations, so the lane counters can never overflow even for huge inputs.
+constexpr size_t BLOCKSIZE = size_t{1} << 24;
+
+__attribute__((target("sse2")))
+unsigned long long count_sse2(const int* data, size_t size, size_t offset) {
+	if (size <= offset)
+		return 0;
+	const size_t pairs = size - offset;
+	unsigned long long count {0};
+	size_t i = 0;
+	while (i + 4 <= pairs) {
+		const size_t block_end = (pairs - i > 4 * BLOCKSIZE) ? i + 4 * BLOCKSIZE : pairs;
+		__m128i lanes = _mm_setzero_si128();
+		for (; i + 4 <= block_end; i += 4) {
+			__m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+			__m128i later = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + offset));
+			// A true comparison is all ones (-1), subtracting it increments the lane counter.
+			lanes = _mm_sub_epi32(lanes, _mm_cmpgt_epi32(later, current));
+		}
+		alignas(16) unsigned int partial[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(partial), lanes);
+		count += static_cast<unsigned long long>(partial[0]) + partial[1] + partial[2] + partial[3];
+	}
+	return count + count_scalar(data + i, size - i, offset);
+}
+
+__attribute__((target("avx2")))
+unsigned long long count_avx2(const int* data, size_t size, size_t offset) {
+	if (size <= offset)
+		return 0;
+	const size_t pairs = size - offset;
+	unsigned long long count {0};
+	size_t i = 0;
+	while (i + 8 <= pairs) {
+		const size_t block_end = (pairs - i > 8 * BLOCKSIZE) ? i + 8 * BLOCKSIZE : pairs;
+		__m256i lanes = _mm256_setzero_si256();
+		for (; i + 8 <= block_end; i += 8) {
+			__m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+			__m256i later = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + offset));
+			lanes = _mm256_sub_epi32(lanes, _mm256_cmpgt_epi32(later, current));
+		}
+		alignas(32) unsigned int partial[8];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(partial), lanes);
+		for (unsigned int lane : partial)
+			count += lane;
+	}
+	return count + count_scalar(data + i, size - i, offset);
+}
+
+__attribute__((target("avx512f")))
+unsigned long long count_avx512(const int* data, size_t size, size_t offset) {
+	if (size <= offset)
+		return 0;
+	const size_t pairs = size - offset;
+	const __m512i ones = _mm512_set1_epi32(1);
+	unsigned long long count {0};
+	size_t i = 0;
+	while (i + 16 <= pairs) {
+		const size_t block_end = (pairs - i > 16 * BLOCKSIZE) ? i + 16 * BLOCKSIZE : pairs;
+		__m512i lanes = _mm512_setzero_si512();
+		for (; i + 16 <= block_end; i += 16) {
+			__m512i current = _mm512_loadu_si512(data + i);
+			__m512i later = _mm512_loadu_si512(data + i + offset);
+			// AVX-512 compares into a mask register, add one only in the lanes where it is set.
+			__mmask16 increased = _mm512_cmpgt_epi32_mask(later, current);
+			lanes = _mm512_mask_add_epi32(lanes, increased, lanes, ones);
+		}
+		// Fold the two halves together and sum the eight lanes, as in the AVX2 kernel. The zero-masked
+		// extracts are the same instruction without the undefined source operand GCC warns about.
+		__m256i halves = _mm256_add_epi32(_mm512_maskz_extracti64x4_epi64(0xFF, lanes, 0), _mm512_maskz_extracti64x4_epi64(0xFF, lanes, 1));
+		alignas(32) unsigned int partial[8];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(partial), halves);
+		for (unsigned int lane : partial)
+			count += lane;
+	}
+	return count + count_scalar(data + i, size - i, offset);
+}
+#endif
+
+bool is_supported(Simd_Level level) {
+#ifdef AOC_X86_KERNELS
+	switch (level) {
+		case Simd_Level::scalar: return true;
+		case Simd_Level::sse2:   return __builtin_cpu_supports("sse2");
+		case Simd_Level::avx2:   return __builtin_cpu_supports("avx2");
+		case Simd_Level::avx512: return __builtin_cpu_supports("avx512f");
+	}
+	return false;
+#else
+	return level == Simd_Level::scalar;
+#endif
+}
+
+} // namespace
+
+Simd_Level detect_simd_level() {
+	// Resolved once, the CPU does not change while the process is running.
+	static const Simd_Level best_level = [] {
+		for (Simd_Level level : {Simd_Level::avx512, Simd_Level::avx2, Simd_Level::sse2})
+			if (is_supported(level))
+				return level;
+		return Simd_Level::scalar;
+	}();
+	return best_level;
+}
+
+const char* simd_level_name(Simd_Level level) {
+	switch (level) {
+		case Simd_Level::scalar: return "scalar";
+		case Simd_Level::sse2:   return "sse2";
+		case Simd_Level::avx2:   return "avx2";
+		case Simd_Level::avx512: return "avx512";
+	}
+	return "unknown";
+}
+
+unsigned long long count_increases_at_offset(const int* data, size_t size, size_t offset) {
+	return count_increases_at_offset(data, size, offset, detect_simd_level());
+}
+
+unsigned long long count_increases_at_offset(const int* data, size_t size, size_t offset, Simd_Level level) {
+	if (!is_supported(level))
+		throw std::runtime_error(std::string("Error: CPU does not support the ") + simd_level_name(level) + " kernel");
+#ifdef AOC_X86_KERNELS
+	switch (level) {
+		case Simd_Level::sse2:   return count_sse2(data, size, offset);
+		case Simd_Level::avx2:   return count_avx2(data, size, offset);
+		case Simd_Level::avx512: return count_avx512(data, size, offset);
+		case Simd_Level::scalar: break;
+	}
+#endif
+	return count_scalar(data, size, offset);
+}
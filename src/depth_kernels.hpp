@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+
+// Vectorized kernels behind the day01 counters.
+// Every kernel counts the indices i for which data[i] < data[i + offset]; an offset of 1 is the
+// simple count and an offset of 3 the three-measurement sliding window count.
+
+// Instruction set levels a kernel is available for, from slowest to fastest.
+enum class Simd_Level { scalar, sse2, avx2, avx512 };
+
+// Best level supported by the running CPU (queried once with CPUID and cached).
+Simd_Level detect_simd_level();
+const char* simd_level_name(Simd_Level level);
+
+// Count with the kernel picked for this CPU at startup.
+unsigned long long count_increases_at_offset(const int* data, size_t size, size_t offset);
+// Count with an explicitly requested kernel, used to compare the variants against each other.
+// Throws std::runtime_error if the CPU does not support the requested level.
+unsigned long long count_increases_at_offset(const int* data, size_t size, size_t offset, Simd_Level level);
@@ -0,0 +1,156 @@
+#include "input.hpp"
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Open the file and load its contents; the descriptor is only needed until the mapping exists.
+Input_File::Input_File(const std::string& filename) {
+	int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	// Throw an exception if the file cannot be opened.
+	if (fd < 0)
+		throw std::runtime_error("Failed to open input file: " + filename);
+	try {
+		load_from_descriptor(fd);
+	} catch (...) {
+		::close(fd);
+		throw;
+	}
+	::close(fd);
+}
+
+Input_File::Input_File(int fd) {
+	load_from_descriptor(fd);
+}
+
+Input_File::~Input_File() {
+	release();
+}
+
+Input_File::Input_File(Input_File&& other) noexcept
+	: data_(std::exchange(other.data_, nullptr)),
+	  size_(std::exchange(other.size_, 0)),
+	  mapped_(std::exchange(other.mapped_, false)),
+	  buffer_(std::move(other.buffer_)) {
+}
+
+Input_File& Input_File::operator=(Input_File&& other) noexcept {
+	if (this != &other) {
+		release();
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+		mapped_ = std::exchange(other.mapped_, false);
+		buffer_ = std::move(other.buffer_);
+	}
+	return *this;
+}
+
+void Input_File::release() {
+	if (mapped_)
+		::munmap(const_cast<char*>(data_), size_);
+	data_ = nullptr;
+	size_ = 0;
+	mapped_ = false;
+	buffer_.clear();
+}
+
+void Input_File::load_from_descriptor(int fd) {
+	struct stat file_status;
+	if (::fstat(fd, &file_status) != 0)
+		throw std::runtime_error(std::string("Failed to stat input file: ") + std::strerror(errno));
+
+	// Regular files with a known size are mapped directly. Files reporting a size of zero
+	// (empty files, but also some virtual files) go through the read() path below.
+	if (S_ISREG(file_status.st_mode) && file_status.st_size > 0) {
+		size_t file_size = static_cast<size_t>(file_status.st_size);
+		void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED) {
+			// The whole file is scanned front to back, so ask the kernel for aggressive read-ahead.
+			::madvise(mapping, file_size, MADV_SEQUENTIAL);
+			data_ = static_cast<const char*>(mapping);
+			size_ = file_size;
+			mapped_ = true;
+			return;
+		}
+	}
+
+	// Buffered fallback for pipes and anything mmap refuses: read big chunks into a growing buffer.
+	constexpr size_t CHUNKSIZE = 1 << 16;
+	size_t used = 0;
+	buffer_.resize(CHUNKSIZE);
+	while (true) {
+		if (buffer_.size() - used < CHUNKSIZE)
+			buffer_.resize(buffer_.size() * 2);
+		ssize_t bytes_read = ::read(fd, buffer_.data() + used, buffer_.size() - used);
+		if (bytes_read < 0) {
+			if (errno == EINTR)
+				continue;
+			throw std::runtime_error(std::string("Failed to read input file: ") + std::strerror(errno));
+		}
+		if (bytes_read == 0)
+			break;
+		used += static_cast<size_t>(bytes_read);
+	}
+	buffer_.resize(used);
+	data_ = buffer_.data();
+	size_ = used;
+}
+
+void Input_File::prefetch() const {
+	if (!mapped_)
+		return;
+	// Start asynchronous read-ahead for everything, then touch one byte per page to wait for it.
+	::madvise(const_cast<char*>(data_), size_, MADV_WILLNEED);
+	const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+	volatile char sink {0};
+	for (size_t offset = 0; offset < size_; offset += page_size)
+		sink = sink + data_[offset];
+}
+
+Line_Buffer::Line_Buffer(const std::string& filename)
+	: Line_Buffer(Input_File(filename)) {
+}
+
+Line_Buffer::Line_Buffer(Input_File&& input_file)
+	: input_file_(std::move(input_file)),
+	  lines_(split_lines(input_file_.contents())) {
+}
+
+size_t count_lines(std::string_view text) {
+	size_t count {0};
+	const char* current = text.data();
+	const char* const end = text.data() + text.size();
+	while (current != end) {
+		const void* newline = std::memchr(current, '\n', static_cast<size_t>(end - current));
+		if (newline == nullptr) {
+			// Last line without a terminating newline still counts as a line.
+			++count;
+			break;
+		}
+		++count;
+		current = static_cast<const char*>(newline) + 1;
+	}
+	return count;
+}
+
+std::vector<std::string_view> split_lines(std::string_view text) {
+	std::vector<std::string_view> lines;
+	lines.reserve(count_lines(text));
+
+	const char* current = text.data();
+	const char* const end = text.data() + text.size();
+	while (current != end) {
+		const char* newline = static_cast<const char*>(std::memchr(current, '\n', static_cast<size_t>(end - current)));
+		if (newline == nullptr) {
+			lines.emplace_back(current, static_cast<size_t>(end - current));
+			break;
+		}
+		lines.emplace_back(current, static_cast<size_t>(newline - current));
+		current = newline + 1;
+	}
+	return lines;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <span>
+#include <vector>
+#include <charconv>
+#include <cstddef>
+
+// Read-only view over the whole contents of an input file.
+// Regular files are memory-mapped so the data is never copied; pipes, FIFOs and anything
+// else that cannot be mapped are read into an owned buffer with large read() calls instead.
+class Input_File {
+public:
+	explicit Input_File(const std::string& filename);
+	// Takes the contents of an already open descriptor (e.g. 0 for stdin), the descriptor is not closed.
+	explicit Input_File(int fd);
+	~Input_File();
+
+	Input_File(const Input_File&) = delete;
+	Input_File& operator=(const Input_File&) = delete;
+	Input_File(Input_File&& other) noexcept;
+	Input_File& operator=(Input_File&& other) noexcept;
+
+	std::string_view contents() const { return {data_, size_}; }
+	// Fault the whole mapping in now, so a later parse does not stall on page faults.
+	// Buffered contents are already in memory and need nothing.
+	void prefetch() const;
+
+private:
+	void load_from_descriptor(int fd);
+	void release();
+
+	const char* data_{nullptr};
+	size_t size_{0};
+	bool mapped_{false};
+	std::vector<char> buffer_;
+};
+
+// A whole input file split into lines. The contents stay in the single mapping or buffer of the
+// Input_File they come from, and the lines are string views into it: loading costs one allocation
+// for the view array instead of one string per line, and consecutive lines are adjacent in memory.
+// The views stay valid as long as the Line_Buffer lives, also after it has been moved.
+class Line_Buffer {
+public:
+	// Throws std::runtime_error if the file cannot be opened, like Input_File.
+	explicit Line_Buffer(const std::string& filename);
+	explicit Line_Buffer(Input_File&& input_file);
+
+	std::string_view contents() const { return input_file_.contents(); }
+	std::span<const std::string_view> lines() const { return lines_; }
+	size_t size() const { return lines_.size(); }
+	bool empty() const { return lines_.empty(); }
+	std::string_view operator[](size_t index) const { return lines_[index]; }
+	auto begin() const { return lines_.begin(); }
+	auto end() const { return lines_.end(); }
+
+private:
+	Input_File input_file_;
+	std::vector<std::string_view> lines_;
+};
+
+// Count the lines of a text the same way repeated std::getline calls would (a trailing newline
+// does not start an extra empty line). Uses memchr, which the C library vectorizes.
+size_t count_lines(std::string_view text);
+
+// Split a text into lines without copying them, following std::getline semantics.
+std::vector<std::string_view> split_lines(std::string_view text);
+
+// Parse whitespace separated integers with std::from_chars. Like 'stream >> n' the parsing stops
+// quietly at the first token that is not an integer. The output is presized from the line count.
+template <typename T>
+std::vector<T> parse_integers(std::string_view text) {
+	std::vector<T> values;
+	values.reserve(count_lines(text));
+
+	const char* current = text.data();
+	const char* const end = text.data() + text.size();
+	while (true) {
+		// Skip whitespace between the numbers (same set of characters as std::isspace).
+		while (current != end && (*current == ' ' || (*current >= '\t' && *current <= '\r')))
+			++current;
+		if (current == end)
+			break;
+		// operator>> accepts an explicit plus sign, std::from_chars does not.
+		if (*current == '+' && current + 1 != end && *(current + 1) >= '0' && *(current + 1) <= '9')
+			++current;
+
+		T value;
+		auto [next, error] = std::from_chars(current, end, value);
+		if (error != std::errc())
+			break;
+		values.push_back(value);
+		current = next;
+	}
+	return values;
+}
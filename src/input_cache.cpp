@@ -0,0 +1,189 @@
+#include "input_cache.hpp"
+#include "input.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char CACHE_MAGIC[8] {'A', 'O', 'C', 'C', 'A', 'C', 'H', 'E'};
+// Bump whenever the layout of a cached structure changes, older caches are then rebuilt.
+constexpr uint32_t CACHE_VERSION {1};
+constexpr size_t MAX_SECTIONS {4};
+// Sections start on cache line boundaries, so every element type is suitably aligned in the mapping.
+constexpr size_t SECTION_ALIGNMENT {64};
+
+struct Cache_Header {
+	char magic[8];
+	uint32_t version;
+	uint32_t kind;
+	uint64_t source_size;
+	int64_t source_modified_ns;
+	uint64_t source_hash;
+	uint64_t parameter;
+	uint64_t section_count;
+	struct {
+		uint64_t offset;
+		uint64_t count;
+		uint64_t element_size;
+	} sections[MAX_SECTIONS];
+};
+
+size_t align_up(size_t value) {
+	return (value + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+// 64-bit multiply-xorshift hash over 8-byte words; fast enough to run over the whole input on every
+// run (much faster than parsing it), which catches edits that keep the size and modification time.
+uint64_t hash_contents(std::string_view contents) {
+	constexpr uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ull;
+	uint64_t hash = contents.size() * MULTIPLIER;
+	size_t i = 0;
+	for (; i + 8 <= contents.size(); i += 8) {
+		uint64_t word;
+		std::memcpy(&word, contents.data() + i, 8);
+		hash = (hash ^ word) * MULTIPLIER;
+		hash ^= hash >> 29;
+	}
+	uint64_t tail {0};
+	std::memcpy(&tail, contents.data() + i, contents.size() - i);
+	hash = (hash ^ tail) * MULTIPLIER;
+	return hash ^ (hash >> 32);
+}
+
+bool write_all(int fd, const void* data, size_t size) {
+	const char* current = static_cast<const char*>(data);
+	while (size > 0) {
+		ssize_t written = ::write(fd, current, size);
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		current += written;
+		size -= static_cast<size_t>(written);
+	}
+	return true;
+}
+
+} // namespace
+
+bool input_cache_enabled() {
+	const char* setting = std::getenv("AOC_INPUT_CACHE");
+	return setting != nullptr && *setting != '\0' && std::strcmp(setting, "0") != 0;
+}
+
+std::string input_cache_path(const std::string& input_path) {
+	return input_path + ".cache";
+}
+
+Input_Fingerprint fingerprint_input(const std::string& input_path, std::string_view contents) {
+	Input_Fingerprint fingerprint;
+	struct stat file_status;
+	if (::stat(input_path.c_str(), &file_status) == 0)
+		fingerprint.modified_ns = static_cast<int64_t>(file_status.st_mtim.tv_sec) * 1'000'000'000 + file_status.st_mtim.tv_nsec;
+	fingerprint.size = contents.size();
+	fingerprint.hash = hash_contents(contents);
+	return fingerprint;
+}
+
+Parsed_Input read_input_cache(const std::string& input_path, Input_Cache_Kind kind, const Input_Fingerprint& fingerprint) {
+	const std::string cache_path = input_cache_path(input_path);
+	int fd = ::open(cache_path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return {};
+	struct stat cache_status;
+	if (::fstat(fd, &cache_status) != 0 || static_cast<size_t>(cache_status.st_size) < sizeof(Cache_Header)) {
+		::close(fd);
+		return {};
+	}
+	const size_t cache_size = static_cast<size_t>(cache_status.st_size);
+	void* mapping = ::mmap(nullptr, cache_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (mapping == MAP_FAILED)
+		return {};
+	// Every section keeps the mapping alive, it is unmapped together with the last of them.
+	std::shared_ptr<const void> owner(mapping, [cache_size](const void* address) {
+		::munmap(const_cast<void*>(address), cache_size);
+	});
+
+	Cache_Header header;
+	std::memcpy(&header, mapping, sizeof(header));
+	if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION
+		|| header.kind != static_cast<uint32_t>(kind) || header.section_count > MAX_SECTIONS
+		|| header.source_size != fingerprint.size || header.source_modified_ns != fingerprint.modified_ns
+		|| header.source_hash != fingerprint.hash)
+		return {};
+
+	std::vector<Input_Section> sections;
+	for (size_t i = 0; i < header.section_count; ++i) {
+		const auto& entry = header.sections[i];
+		// A truncated or corrupted cache must never be read past its end.
+		if (entry.offset % SECTION_ALIGNMENT != 0 || entry.offset > cache_size || entry.element_size == 0
+			|| entry.count > (cache_size - entry.offset) / entry.element_size)
+			return {};
+		sections.push_back({static_cast<const char*>(mapping) + entry.offset, entry.count, entry.element_size, owner});
+	}
+	return Parsed_Input(std::move(sections), header.parameter, true);
+}
+
+bool write_input_cache(const std::string& input_path, Input_Cache_Kind kind, const Input_Fingerprint& fingerprint,
+		const Parsed_Input& parsed) {
+	if (parsed.section_count() > MAX_SECTIONS)
+		throw std::runtime_error("Error: a cached input holds at most " + std::to_string(MAX_SECTIONS) + " sections");
+
+	Cache_Header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.version = CACHE_VERSION;
+	header.kind = static_cast<uint32_t>(kind);
+	header.source_size = fingerprint.size;
+	header.source_modified_ns = fingerprint.modified_ns;
+	header.source_hash = fingerprint.hash;
+	header.parameter = parsed.parameter();
+	header.section_count = parsed.section_count();
+	size_t offset = align_up(sizeof(header));
+	for (size_t i = 0; i < parsed.section_count(); ++i) {
+		const Input_Section& section = parsed.raw_section(i);
+		header.sections[i] = {offset, section.count, section.element_size};
+		offset = align_up(offset + section.count * section.element_size);
+	}
+
+	// Written under a temporary name and renamed, so concurrent runs never see a partial cache.
+	const std::string cache_path = input_cache_path(input_path);
+	const std::string temporary_path = cache_path + ".tmp." + std::to_string(::getpid());
+	int fd = ::open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0)
+		return false;
+	static const char padding[SECTION_ALIGNMENT] {};
+	bool written = write_all(fd, &header, sizeof(header)) && write_all(fd, padding, align_up(sizeof(header)) - sizeof(header));
+	for (size_t i = 0; written && i < parsed.section_count(); ++i) {
+		const Input_Section& section = parsed.raw_section(i);
+		const size_t bytes = section.count * section.element_size;
+		written = write_all(fd, section.data, bytes) && write_all(fd, padding, align_up(bytes) - bytes);
+	}
+	written = (::close(fd) == 0) && written;
+	if (!written || ::rename(temporary_path.c_str(), cache_path.c_str()) != 0) {
+		::unlink(temporary_path.c_str());
+		return false;
+	}
+	return true;
+}
+
+Parsed_Input load_parsed_input(const std::string& input_path, Input_Cache_Kind kind,
+		const std::function<Parsed_Input(std::string_view contents)>& parse) {
+	Input_File input_file(input_path);
+	if (!input_cache_enabled())
+		return parse(input_file.contents());
+
+	const Input_Fingerprint fingerprint {fingerprint_input(input_path, input_file.contents())};
+	Parsed_Input cached {read_input_cache(input_path, kind, fingerprint)};
+	if (cached.section_count() > 0)
+		return cached;
+	Parsed_Input parsed {parse(input_file.contents())};
+	write_input_cache(input_path, kind, fingerprint, parsed);
+	return parsed;
+}
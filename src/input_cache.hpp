@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Binary cache of parsed inputs for repeated runs over the same large files.
+// With AOC_INPUT_CACHE=1 in the environment, the parsed form of data/dayXX_input.txt (integer arrays,
+// packed diagnostic rows, board matrices, line endpoints) is written to data/dayXX_input.txt.cache
+// after a parse. Later runs map that file and use its arrays in place, without any parsing.
+// A cache is only used if the input still has the size, modification time and content hash it
+// was built from, and if it was written by the same cache version for the same kind of data.
+// Without AOC_INPUT_CACHE every run parses, and no cache file is read or written.
+
+// What a cache file holds, stored in its header so a cache is never read as another day's data.
+enum class Input_Cache_Kind : uint32_t { depths = 1, commands, diagnostic_rows, bingo, vent_lines };
+
+// One array of a parsed input. 'owner' keeps the data alive: the parsed vector, or the cache mapping.
+struct Input_Section {
+	const void* data {nullptr};
+	size_t count {0};
+	size_t element_size {0};
+	std::shared_ptr<const void> owner;
+};
+
+// Wrap a parsed array as a section without copying it.
+template <typename T>
+Input_Section make_input_section(std::vector<T> values) {
+	static_assert(std::is_trivially_copyable_v<T>, "cached sections are stored as raw bytes");
+	auto owned = std::make_shared<const std::vector<T>>(std::move(values));
+	return Input_Section{owned->data(), owned->size(), sizeof(T), owned};
+}
+
+// The arrays of one parsed input, either owned (just parsed) or mapped from a cache file.
+class Parsed_Input {
+public:
+	Parsed_Input() = default;
+	// 'parameter' is one number of metadata that goes with the arrays, e.g. the width of packed rows.
+	explicit Parsed_Input(std::vector<Input_Section> sections, uint64_t parameter = 0, bool from_cache = false)
+		: sections_(std::move(sections)), parameter_(parameter), from_cache_(from_cache) {}
+
+	// Typed view of section 'index'. Throws std::runtime_error if it holds elements of another size.
+	template <typename T>
+	std::span<const T> section(size_t index) const {
+		const Input_Section& section = sections_.at(index);
+		if (section.count > 0 && section.element_size != sizeof(T))
+			throw std::runtime_error("Error: parsed input section " + std::to_string(index) + " has elements of "
+				+ std::to_string(section.element_size) + " bytes, expected " + std::to_string(sizeof(T)));
+		return {static_cast<const T*>(section.data), section.count};
+	}
+	const Input_Section& raw_section(size_t index) const { return sections_.at(index); }
+	size_t section_count() const { return sections_.size(); }
+	uint64_t parameter() const { return parameter_; }
+	bool from_cache() const { return from_cache_; }
+
+private:
+	std::vector<Input_Section> sections_;
+	uint64_t parameter_ {0};
+	bool from_cache_ {false};
+};
+
+// Identity of an input file's contents at the time it was parsed.
+struct Input_Fingerprint {
+	uint64_t size {0};
+	int64_t modified_ns {0};
+	uint64_t hash {0};
+};
+
+// True if AOC_INPUT_CACHE is set to anything but "0" or an empty string.
+bool input_cache_enabled();
+// Path of the cache that belongs to an input file.
+std::string input_cache_path(const std::string& input_path);
+// Size and modification time of the file at 'input_path' and the hash of 'contents'.
+Input_Fingerprint fingerprint_input(const std::string& input_path, std::string_view contents);
+// Map a valid cache, or return an empty Parsed_Input (section_count() == 0) if there is none or it is stale.
+Parsed_Input read_input_cache(const std::string& input_path, Input_Cache_Kind kind, const Input_Fingerprint& fingerprint);
+// Write the cache atomically (temporary file and rename). Returns false if it could not be written,
+// which only costs the next run a parse.
+bool write_input_cache(const std::string& input_path, Input_Cache_Kind kind, const Input_Fingerprint& fingerprint,
+	const Parsed_Input& parsed);
+
+// Parsed form of 'input_path': from its cache if caching is enabled and the cache is valid, otherwise
+// from 'parse' over the file contents (refreshing the cache if enabled). Throws std::runtime_error if
+// the input cannot be opened, and passes on whatever 'parse' throws.
+Parsed_Input load_parsed_input(const std::string& input_path, Input_Cache_Kind kind,
+	const std::function<Parsed_Input(std::string_view contents)>& parse);
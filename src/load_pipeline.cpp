@@ -0,0 +1,54 @@
+#include "load_pipeline.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+
+void read_text_blocks(const std::string& filename, const Load_Pipeline_Options& options, Bounded_Queue<Text_Block>& blocks) {
+	int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		throw std::runtime_error("Failed to open input file: " + filename);
+	struct Descriptor_Guard {
+		int fd;
+		~Descriptor_Guard() { ::close(fd); }
+	} guard {fd};
+#ifdef POSIX_FADV_SEQUENTIAL
+	// Let the kernel read ahead aggressively, the file is read once from start to end.
+	::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+	const size_t block_size = std::max<size_t>(1, options.block_size);
+	std::string carried;
+	size_t index {0};
+	while (true) {
+		std::string text {std::move(carried)};
+		carried.clear();
+		const size_t previous_size = text.size();
+		text.resize(previous_size + block_size);
+		ssize_t bytes_read;
+		do
+			bytes_read = ::read(fd, text.data() + previous_size, block_size);
+		while (bytes_read < 0 && errno == EINTR);
+		if (bytes_read < 0)
+			throw std::runtime_error("Error: failed to read " + filename + ": " + std::strerror(errno));
+		text.resize(previous_size + static_cast<size_t>(bytes_read));
+
+		if (bytes_read == 0) {
+			// End of the file: whatever is left is the last block, with or without a final separator.
+			if (!text.empty())
+				blocks.push({index, std::move(text)});
+			return;
+		}
+		size_t cut = text.rfind(options.separator);
+		if (cut == std::string::npos) {
+			carried = std::move(text);
+			continue;
+		}
+		cut += options.separator.size();
+		carried.assign(text, cut);
+		text.resize(cut);
+		if (!blocks.push({index++, std::move(text)}))
+			return;
+	}
+}
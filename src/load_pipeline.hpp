@@ -0,0 +1,156 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Producer/consumer pipeline for loading large inputs while they are being solved.
+// One reader thread reads the file in large blocks and cuts every block after the last separator
+// in it (a newline, or a blank line for inputs made of records), carrying the rest over to the next
+// block. Parser threads turn the blocks into batches of parsed records, and the calling thread hands
+// every batch to the solver as soon as it is ready. All queues are bounded, so reading runs at most
+// a few blocks ahead of parsing and memory use does not depend on the size of the input.
+// Batches reach the consumer in completion order; every batch carries the index of its block, so
+// consumers that care about the input order can restore it.
+
+// Queue with a fixed capacity shared by the pipeline stages.
+template <typename T>
+class Bounded_Queue {
+public:
+	explicit Bounded_Queue(size_t capacity) : capacity_(std::max<size_t>(1, capacity)) {}
+
+	// Block while the queue is full. Returns false (dropping 'value') once the queue is closed.
+	bool push(T value) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		not_full_.wait(lock, [this] { return items_.size() < capacity_ || closed_; });
+		if (closed_)
+			return false;
+		items_.push_back(std::move(value));
+		not_empty_.notify_one();
+		return true;
+	}
+	// Block while the queue is empty. Returns std::nullopt once it is closed and drained.
+	std::optional<T> pop() {
+		std::unique_lock<std::mutex> lock(mutex_);
+		not_empty_.wait(lock, [this] { return !items_.empty() || closed_; });
+		if (items_.empty())
+			return std::nullopt;
+		T value {std::move(items_.front())};
+		items_.pop_front();
+		not_full_.notify_one();
+		return value;
+	}
+	// No more pushes; the queued items can still be popped.
+	void close() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		closed_ = true;
+		not_empty_.notify_all();
+		not_full_.notify_all();
+	}
+	// Close and drop the queued items, used to stop all stages after an error.
+	void cancel() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		closed_ = true;
+		items_.clear();
+		not_empty_.notify_all();
+		not_full_.notify_all();
+	}
+
+private:
+	const size_t capacity_;
+	std::mutex mutex_;
+	std::condition_variable not_empty_;
+	std::condition_variable not_full_;
+	std::deque<T> items_;
+	bool closed_ {false};
+};
+
+// A block of whole records, 'index' counts the blocks from the start of the file.
+struct Text_Block {
+	size_t index {0};
+	std::string text;
+};
+
+struct Load_Pipeline_Options {
+	// Bytes read per read() call; a block is this size plus the records carried over.
+	size_t block_size {1 << 20};
+	// Blocks only end right after a separator (a block without one keeps growing).
+	std::string_view separator {"\n"};
+	// Parser threads, 0 = one per hardware thread besides the reader and the consumer (at least one).
+	unsigned parser_count {0};
+};
+
+// Reader stage: push the blocks of 'filename' until the end of the file or until the queue is
+// closed. Throws std::runtime_error if the file cannot be opened or read.
+void read_text_blocks(const std::string& filename, const Load_Pipeline_Options& options, Bounded_Queue<Text_Block>& blocks);
+
+// Run the pipeline over 'filename': 'parse' (Text_Block -> Batch) runs on the parser threads,
+// 'consume' (Batch) on the calling thread. The first exception thrown by any stage stops all of
+// them and is rethrown here once every thread has finished.
+template <typename Batch, typename Parse, typename Consume>
+void run_load_pipeline(const std::string& filename, const Load_Pipeline_Options& options, Parse&& parse, Consume&& consume) {
+	unsigned parser_count = options.parser_count;
+	if (parser_count == 0)
+		parser_count = std::max(1u, std::thread::hardware_concurrency() - std::min(2u, std::thread::hardware_concurrency()));
+	// Two entries per parser: one being worked on, one ready (double buffering between the stages).
+	Bounded_Queue<Text_Block> blocks(2 * parser_count);
+	Bounded_Queue<Batch> batches(2 * parser_count);
+
+	std::mutex error_mutex;
+	std::exception_ptr error;
+	auto fail = [&](std::exception_ptr exception) {
+		{
+			std::lock_guard<std::mutex> lock(error_mutex);
+			if (!error)
+				error = exception;
+		}
+		blocks.cancel();
+		batches.cancel();
+	};
+
+	std::thread reader([&] {
+		try {
+			read_text_blocks(filename, options, blocks);
+		} catch (...) {
+			fail(std::current_exception());
+		}
+		blocks.close();
+	});
+	std::atomic<unsigned> running_parsers {parser_count};
+	std::vector<std::thread> parsers;
+	for (unsigned i = 0; i < parser_count; ++i) {
+		parsers.emplace_back([&] {
+			try {
+				while (std::optional<Text_Block> block = blocks.pop())
+					if (!batches.push(parse(std::move(*block))))
+						break;
+			} catch (...) {
+				fail(std::current_exception());
+			}
+			// The last parser to finish ends the stream of batches.
+			if (--running_parsers == 0)
+				batches.close();
+		});
+	}
+
+	try {
+		while (std::optional<Batch> batch = batches.pop())
+			consume(std::move(*batch));
+	} catch (...) {
+		fail(std::current_exception());
+	}
+	reader.join();
+	for (std::thread& parser : parsers)
+		parser.join();
+	if (error)
+		std::rethrow_exception(error);
+}
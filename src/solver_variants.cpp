@@ -0,0 +1,283 @@
+#include "solver_variants.hpp"
+#include "constexpr_solvers.hpp"
+#include "depth_kernels.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Inputs from which splitting the work over threads pays off.
+constexpr size_t PARALLEL_MIN_INPUT_SIZE = size_t{4} << 20;
+
+// Day 01
+
+template <size_t OFFSET, Simd_Level LEVEL>
+std::string depths_at_level(std::string_view input, unsigned) {
+	std::vector<int> data {parse_integers<int>(input)};
+	return std::to_string(count_increases_at_offset(data.data(), data.size(), OFFSET, LEVEL));
+}
+
+template <Simd_Level LEVEL>
+bool simd_level_available() {
+	return static_cast<int>(LEVEL) <= static_cast<int>(detect_simd_level());
+}
+
+template <size_t OFFSET>
+std::string depths_parallel(std::string_view input, unsigned thread_count) {
+	std::vector<int> data {parse_integers<int>(input)};
+	return std::to_string(count_window_increases(data, OFFSET, thread_count));
+}
+
+template <size_t OFFSET>
+std::string depths_streaming(std::string_view input, unsigned) {
+	Depth_Increase_Counter counter;
+	counter.push(parse_integers<int>(input));
+	return std::to_string(OFFSET == 1 ? counter.simple_count : counter.sliding_window_count);
+}
+
+template <size_t OFFSET>
+std::string depths_constexpr(std::string_view input, unsigned) {
+	std::vector<int> data {parse_depths(input)};
+	return std::to_string(OFFSET == 1 ? count_increases_simple(std::span<const int>(data)) : count_increases_sliding_window(std::span<const int>(data)));
+}
+
+// Day 02
+
+template <bool WITH_AIM>
+std::string course_reference(std::string_view input, unsigned) {
+	std::vector<std::string_view> lines {split_lines(input)};
+	return std::to_string(WITH_AIM ? calculate_final_position_with_aim(lines) : calculate_final_position(lines));
+}
+
+template <bool WITH_AIM>
+std::string course_parallel(std::string_view input, unsigned thread_count) {
+	Course_Result result {calculate_final_positions_parallel(input, thread_count)};
+	return std::to_string(WITH_AIM ? result.final_position_with_aim : result.final_position);
+}
+
+template <bool WITH_AIM>
+std::string course_constexpr(std::string_view input, unsigned) {
+	return std::to_string(calculate_course_product(input, WITH_AIM));
+}
+
+// Day 03
+
+std::string gamma_epsilon_bit_columns(std::string_view input, unsigned) {
+	return std::to_string(calculate_gamma_epsilon_product(split_lines(input)));
+}
+
+std::string gamma_epsilon_packed_rows(std::string_view input, unsigned) {
+	Sorted_Diagnostic_Index index {build_sorted_index(build_bit_columns(split_lines(input)))};
+	return std::to_string(calculate_gamma_epsilon_product(index.values, index.width));
+}
+
+std::string gamma_epsilon_constexpr(std::string_view input, unsigned) {
+	return std::to_string(calculate_gamma_epsilon_product(input));
+}
+
+std::string life_support_sorted_index(std::string_view input, unsigned) {
+	return std::to_string(calculate_life_support_rating(split_lines(input)));
+}
+
+std::string life_support_constexpr(std::string_view input, unsigned) {
+	return std::to_string(calculate_life_support_rating(input));
+}
+
+// Day 04
+
+struct Bingo_Input {
+	std::vector<int> bingo_sequence;
+	std::vector<Bingo_Board> boards;
+};
+
+Bingo_Input parse_bingo_input(std::string_view input) {
+	std::istringstream stream {std::string(input)};
+	Bingo_Input parsed;
+	parsed.bingo_sequence = load_bingo_sequence(stream);
+	parsed.boards = load_bingo_boards(stream);
+	return parsed;
+}
+
+template <bool LAST_WINNER>
+std::string bingo_simulation(std::string_view input, unsigned) {
+	Bingo_Input parsed {parse_bingo_input(input)};
+	return std::to_string(LAST_WINNER ? calculate_bingo_last_winner_score(parsed.bingo_sequence, parsed.boards)
+		: calculate_bingo_first_winner_score(parsed.bingo_sequence, parsed.boards));
+}
+
+template <bool LAST_WINNER>
+std::string bingo_indexed(std::string_view input, unsigned) {
+	Bingo_Input parsed {parse_bingo_input(input)};
+	const Bingo_Number_Index index {build_bingo_index(parsed.boards)};
+	return std::to_string(LAST_WINNER ? calculate_bingo_last_winner_score(parsed.bingo_sequence, parsed.boards, index)
+		: calculate_bingo_first_winner_score(parsed.bingo_sequence, parsed.boards, index));
+}
+
+// The structure-of-arrays board set stores the board numbers in 16 bits.
+bool bingo_numbers_fit(std::string_view input) {
+	for (const Bingo_Board& board : parse_bingo_input(input).boards)
+		for (const auto& row : board.contents)
+			for (int number : row)
+				if (number < 0 || number > UINT16_MAX)
+					return false;
+	return true;
+}
+
+template <bool LAST_WINNER>
+std::string bingo_soa(std::string_view input, unsigned) {
+	Bingo_Input parsed {parse_bingo_input(input)};
+	Bingo_Board_Set set {build_bingo_board_set(parsed.boards)};
+	Bingo_Results results {calculate_bingo_scores_soa(parsed.bingo_sequence, set)};
+	return std::to_string(LAST_WINNER ? results.last_winner_score : results.first_winner_score);
+}
+
+template <bool LAST_WINNER>
+std::string bingo_win_turns(std::string_view input, unsigned thread_count) {
+	Bingo_Input parsed {parse_bingo_input(input)};
+	Bingo_Results results {calculate_bingo_scores_parallel(parsed.bingo_sequence, parsed.boards, thread_count)};
+	return std::to_string(LAST_WINNER ? results.last_winner_score : results.first_winner_score);
+}
+
+// Day 05
+
+template <bool DIAGONALS>
+std::string vents_scalar(std::string_view input, unsigned) {
+	std::vector<Vent_Line> vent_lines {load_vent_lines(split_lines(input))};
+	Vent_Diagram diagram(vent_lines);
+	draw_straight_lines(vent_lines, diagram);
+	if (DIAGONALS)
+		draw_diagonal_lines(vent_lines, diagram);
+	return std::to_string(count_overlaps(diagram));
+}
+
+template <bool DIAGONALS>
+std::string vents_tiled(std::string_view input, unsigned thread_count) {
+	std::vector<Vent_Line> vent_lines {load_vent_lines(split_lines(input))};
+	Vent_Diagram diagram(vent_lines);
+	long long overlaps {draw_straight_lines_tiled(vent_lines, diagram, thread_count)};
+	if (DIAGONALS)
+		overlaps = draw_diagonal_lines_tiled(vent_lines, diagram, thread_count);
+	return std::to_string(overlaps);
+}
+
+// The grid variants allocate the whole bounding box, the analytic one needs no grid.
+bool vents_grid_fits(std::string_view input) {
+	return vent_diagram_fits(load_vent_lines(split_lines(input)));
+}
+
+template <bool DIAGONALS>
+std::string vents_analytic(std::string_view input, unsigned) {
+	return std::to_string(count_overlaps_analytic(load_vent_lines(split_lines(input)), DIAGONALS));
+}
+
+} // namespace
+
+const std::vector<Solver_Variant>& solver_variants() {
+	static const std::vector<Solver_Variant> variants {
+		{1, 1, "scalar", depths_at_level<1, Simd_Level::scalar>, nullptr, 0, 0},
+		{1, 1, "sse2", depths_at_level<1, Simd_Level::sse2>, simd_level_available<Simd_Level::sse2>, 1, 0},
+		{1, 1, "avx2", depths_at_level<1, Simd_Level::avx2>, simd_level_available<Simd_Level::avx2>, 2, 0},
+		{1, 1, "avx512", depths_at_level<1, Simd_Level::avx512>, simd_level_available<Simd_Level::avx512>, 3, 0},
+		{1, 1, "parallel", depths_parallel<1>, nullptr, 4, PARALLEL_MIN_INPUT_SIZE},
+		{1, 1, "streaming", depths_streaming<1>, nullptr, -1, 0},
+		{1, 1, "constexpr", depths_constexpr<1>, nullptr, -1, 0},
+		{1, 2, "scalar", depths_at_level<3, Simd_Level::scalar>, nullptr, 0, 0},
+		{1, 2, "sse2", depths_at_level<3, Simd_Level::sse2>, simd_level_available<Simd_Level::sse2>, 1, 0},
+		{1, 2, "avx2", depths_at_level<3, Simd_Level::avx2>, simd_level_available<Simd_Level::avx2>, 2, 0},
+		{1, 2, "avx512", depths_at_level<3, Simd_Level::avx512>, simd_level_available<Simd_Level::avx512>, 3, 0},
+		{1, 2, "parallel", depths_parallel<3>, nullptr, 4, PARALLEL_MIN_INPUT_SIZE},
+		{1, 2, "streaming", depths_streaming<3>, nullptr, -1, 0},
+		{1, 2, "constexpr", depths_constexpr<3>, nullptr, -1, 0},
+
+		// The single pass over the raw text beats splitting it into lines first at any size.
+		{2, 1, "reference", course_reference<false>, nullptr, 0, 0},
+		{2, 1, "parallel", course_parallel<false>, nullptr, 1, 0},
+		{2, 1, "constexpr", course_constexpr<false>, nullptr, -1, 0},
+		{2, 2, "reference", course_reference<true>, nullptr, 0, 0},
+		{2, 2, "parallel", course_parallel<true>, nullptr, 1, 0},
+		{2, 2, "constexpr", course_constexpr<true>, nullptr, -1, 0},
+
+		{3, 1, "bit_columns", gamma_epsilon_bit_columns, nullptr, 1, 0},
+		{3, 1, "packed_rows", gamma_epsilon_packed_rows, nullptr, 0, 0},
+		{3, 1, "constexpr", gamma_epsilon_constexpr, nullptr, -1, 0},
+		{3, 2, "sorted_index", life_support_sorted_index, nullptr, 0, 0},
+		{3, 2, "constexpr", life_support_constexpr, nullptr, -1, 0},
+
+		// The structure-of-arrays variant is never picked automatically, and it is skipped for inputs with
+		// board numbers above 65535.
+		{4, 1, "simulation", bingo_simulation<false>, nullptr, 0, 0},
+		{4, 1, "indexed", bingo_indexed<false>, nullptr, 1, 0},
+		{4, 1, "soa", bingo_soa<false>, nullptr, -1, 0, bingo_numbers_fit},
+		{4, 1, "win_turns", bingo_win_turns<false>, nullptr, 2, 0},
+		{4, 2, "simulation", bingo_simulation<true>, nullptr, 0, 0},
+		{4, 2, "indexed", bingo_indexed<true>, nullptr, 1, 0},
+		{4, 2, "soa", bingo_soa<true>, nullptr, -1, 0, bingo_numbers_fit},
+		{4, 2, "win_turns", bingo_win_turns<true>, nullptr, 2, 0},
+
+		{5, 1, "scalar", vents_scalar<false>, nullptr, 0, 0, vents_grid_fits},
+		{5, 1, "tiled", vents_tiled<false>, nullptr, 2, 0, vents_grid_fits},
+		{5, 1, "analytic", vents_analytic<false>, nullptr, 1, 0},
+		{5, 2, "scalar", vents_scalar<true>, nullptr, 0, 0, vents_grid_fits},
+		{5, 2, "tiled", vents_tiled<true>, nullptr, 2, 0, vents_grid_fits},
+		{5, 2, "analytic", vents_analytic<true>, nullptr, 1, 0},
+	};
+	return variants;
+}
+
+std::vector<const Solver_Variant*> find_solver_variants(int day, int part) {
+	std::vector<const Solver_Variant*> found;
+	for (const Solver_Variant& variant : solver_variants())
+		if (variant.day == day && variant.part == part)
+			found.push_back(&variant);
+	return found;
+}
+
+const Solver_Variant* find_solver_variant(int day, int part, std::string_view name) {
+	for (const Solver_Variant* variant : find_solver_variants(day, part))
+		if (name == variant->name)
+			return variant;
+	return nullptr;
+}
+
+const Solver_Variant& select_solver_variant(int day, int part, std::string_view input) {
+	const std::vector<const Solver_Variant*> variants {find_solver_variants(day, part)};
+	if (variants.empty())
+		throw std::runtime_error("Error: day " + std::to_string(day) + " part " + std::to_string(part) + " has no solver variants");
+	// The reference qualifies whatever its preference and size. The candidates are ranked first, so the
+	// content checks, which may parse the input, only run until one variant suits it.
+	std::vector<const Solver_Variant*> candidates;
+	for (const Solver_Variant* variant : variants)
+		if (variant == variants.front() || (variant->preference >= 0 && input.size() >= variant->min_input_size && variant->available()))
+			candidates.push_back(variant);
+	std::stable_sort(candidates.begin(), candidates.end(), [&](const Solver_Variant* a, const Solver_Variant* b){
+		return std::max(a->preference, 0) > std::max(b->preference, 0);
+	});
+	for (const Solver_Variant* variant : candidates)
+		if (variant->suits(input))
+			return *variant;
+	return *variants.front();
+}
+
+Variant_Verification verify_solver_variants(int day, int part, std::string_view input, unsigned thread_count) {
+	Variant_Verification verification;
+	verification.agree = true;
+	for (const Solver_Variant* variant : find_solver_variants(day, part)) {
+		if (!variant->available() || !variant->suits(input))
+			continue;
+		Variant_Result result {variant, {}, {}};
+		try {
+			result.answer = variant->solve(input, thread_count);
+		} catch (const std::exception& exception) {
+			result.error = exception.what();
+		}
+		if (!result.error.empty() || (!verification.results.empty() && result.answer != verification.results.front().answer))
+			verification.agree = false;
+		verification.results.push_back(std::move(result));
+	}
+	if (verification.results.empty())
+		verification.agree = false;
+	return verification;
+}
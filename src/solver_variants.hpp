@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Every implementation of every part, so faster variants can ship next to the reference one.
+// A variant solves one part from the complete input text. The first variant registered for a part
+// is its reference; the others must give exactly the same answers. aoc_runner picks one variant per
+// part by name (--variant) or automatically, or runs all of them and compares the answers (--verify).
+
+struct Solver_Variant {
+	int day;
+	int part;
+	// Short name used on the command line, e.g. "scalar", "avx2" or "parallel".
+	const char* name;
+	// Answer of the part for the complete input text; 'thread_count' as for Day_Solver.
+	std::string (*solve)(std::string_view input, unsigned thread_count);
+	// nullptr if the variant runs everywhere, otherwise checks the CPU it runs on.
+	bool (*is_available)();
+	// Automatic selection takes the available variant with the highest preference whose
+	// 'min_input_size' the input reaches. Variants below 0 are only run when asked for.
+	int preference;
+	size_t min_input_size;
+	// nullptr if the variant takes any input, otherwise checks that it can solve this one (e.g. that its
+	// grid fits in memory). Unsuited variants are neither selected nor verified.
+	bool (*suits_input)(std::string_view input) {nullptr};
+
+	bool available() const { return is_available == nullptr || is_available(); }
+	bool suits(std::string_view input) const { return suits_input == nullptr || suits_input(input); }
+};
+
+// All variants, grouped by day and part with the reference first.
+const std::vector<Solver_Variant>& solver_variants();
+// Variants of one part (available or not), reference first; empty if the part has none.
+std::vector<const Solver_Variant*> find_solver_variants(int day, int part);
+// Variant of a part by name, or nullptr if there is none with that name.
+const Solver_Variant* find_solver_variant(int day, int part, std::string_view name);
+// Automatic choice for this input, by its size and, where a variant checks it, its content. Throws
+// std::runtime_error if the part has no variants.
+const Solver_Variant& select_solver_variant(int day, int part, std::string_view input);
+
+// Result of one variant in a differential run; 'error' holds the message if it threw.
+struct Variant_Result {
+	const Solver_Variant* variant;
+	std::string answer;
+	std::string error;
+};
+struct Variant_Verification {
+	std::vector<Variant_Result> results;
+	// True if every variant answered and all answers equal the reference answer.
+	bool agree {false};
+};
+// Run every available variant of a part that suits the input on it, one after the other. The first of
+// them (the reference unless it does not suit the input) gives the expected answer.
+Variant_Verification verify_solver_variants(int day, int part, std::string_view input, unsigned thread_count);
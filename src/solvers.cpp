@@ -0,0 +1,68 @@
+#include "solvers.hpp"
+#include "utils.hpp"
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+void require_data(std::string_view input) {
+	if (count_lines(input) == 0)
+		throw std::runtime_error("Error: No data loaded.");
+}
+
+Day_Answers solve_day01(std::string_view input, unsigned) {
+	require_data(input);
+	std::vector<int> data {parse_integers<int>(input)};
+	return {std::to_string(count_increases_simple(data)), std::to_string(count_increases_sliding_window(data))};
+}
+
+Day_Answers solve_day02(std::string_view input, unsigned thread_count) {
+	require_data(input);
+	Course_Result result {calculate_final_positions_parallel(input, thread_count)};
+	return {std::to_string(result.final_position), std::to_string(result.final_position_with_aim)};
+}
+
+Day_Answers solve_day03(std::string_view input, unsigned) {
+	require_data(input);
+	std::vector<std::string_view> data {split_lines(input)};
+	return {std::to_string(calculate_gamma_epsilon_product(data)), std::to_string(calculate_life_support_rating(data))};
+}
+
+Day_Answers solve_day04(std::string_view input, unsigned thread_count) {
+	require_data(input);
+	std::istringstream stream {std::string(input)};
+	std::vector<int> bingo_sequence = load_bingo_sequence(stream);
+	const std::vector<Bingo_Board> boards = load_bingo_boards(stream);
+	Bingo_Results results {calculate_bingo_scores_parallel(bingo_sequence, boards, thread_count)};
+	return {std::to_string(results.first_winner_score), std::to_string(results.last_winner_score)};
+}
+
+Day_Answers solve_day05(std::string_view input, unsigned thread_count) {
+	require_data(input);
+	std::vector<Vent_Line> vent_lines = load_vent_lines(split_lines(input));
+	if (!vent_diagram_fits(vent_lines))
+		return {std::to_string(count_overlaps_analytic(vent_lines, false)), std::to_string(count_overlaps_analytic(vent_lines, true))};
+	Vent_Diagram diagram(vent_lines);
+	std::string part1 {std::to_string(draw_straight_lines_tiled(vent_lines, diagram, thread_count))};
+	return {part1, std::to_string(draw_diagonal_lines_tiled(vent_lines, diagram, thread_count))};
+}
+
+} // namespace
+
+const std::vector<Day_Solver>& day_solvers() {
+	static const std::vector<Day_Solver> solvers {
+		{1, "day01", solve_day01},
+		{2, "day02", solve_day02},
+		{3, "day03", solve_day03},
+		{4, "day04", solve_day04},
+		{5, "day05", solve_day05},
+	};
+	return solvers;
+}
+
+const Day_Solver* find_day_solver(int day) {
+	for (const Day_Solver& solver : day_solvers())
+		if (solver.day == day)
+			return &solver;
+	return nullptr;
+}
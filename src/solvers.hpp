@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Every day behind one interface, so a single process can run any set of days (see aoc_runner.cpp).
+// The dayXX executables keep their own main; the solvers here compute the same answers.
+
+struct Day_Answers {
+	std::string part1;
+	std::string part2;
+};
+
+struct Day_Solver {
+	int day;
+	// Executable and input file prefix, e.g. "day01" for data/day01_input.txt.
+	const char* name;
+	// Solve both parts from the complete input text. 'thread_count' bounds the threads the
+	// parallel solvers start themselves (0 means all cores). Throws std::runtime_error on empty input.
+	Day_Answers (*solve)(std::string_view input, unsigned thread_count);
+};
+
+// All implemented days, ordered by day number.
+const std::vector<Day_Solver>& day_solvers();
+// Solver for a day number, or nullptr if that day is not implemented.
+const Day_Solver* find_day_solver(int day);
@@ -0,0 +1,99 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Pool and worker index of the current thread, so tasks submitted by a task stay with its worker.
+thread_local const Work_Stealing_Pool* current_pool {nullptr};
+thread_local size_t current_worker {SIZE_MAX};
+
+} // namespace
+
+Work_Stealing_Pool::Work_Stealing_Pool(unsigned thread_count) {
+	if (thread_count == 0)
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned i = 0; i < thread_count; ++i)
+		queues_.push_back(std::make_unique<Task_Queue>());
+	for (unsigned i = 0; i < thread_count; ++i)
+		workers_.emplace_back([this, i] { run_worker(i); });
+}
+
+Work_Stealing_Pool::~Work_Stealing_Pool() {
+	wait_idle();
+	{
+		std::lock_guard<std::mutex> lock(state_mutex_);
+		stopping_ = true;
+	}
+	work_available_.notify_all();
+	for (std::thread& worker : workers_)
+		worker.join();
+}
+
+void Work_Stealing_Pool::submit(std::function<void()> task) {
+	const size_t index = (current_pool == this) ? current_worker : next_queue_.fetch_add(1) % queues_.size();
+	{
+		std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+		queues_[index]->tasks.push_back(std::move(task));
+	}
+	{
+		std::lock_guard<std::mutex> lock(state_mutex_);
+		++queued_;
+		++unfinished_;
+	}
+	work_available_.notify_one();
+}
+
+void Work_Stealing_Pool::wait_idle() {
+	std::unique_lock<std::mutex> lock(state_mutex_);
+	all_done_.wait(lock, [this] { return unfinished_ == 0; });
+}
+
+bool Work_Stealing_Pool::try_pop(size_t index, std::function<void()>& task) {
+	// Own deque from the back first.
+	{
+		std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+		if (!queues_[index]->tasks.empty()) {
+			task = std::move(queues_[index]->tasks.back());
+			queues_[index]->tasks.pop_back();
+			return true;
+		}
+	}
+	// Then steal from the front of the others, starting at the neighbour so thieves spread out.
+	for (size_t offset = 1; offset < queues_.size(); ++offset) {
+		Task_Queue& victim = *queues_[(index + offset) % queues_.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty()) {
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void Work_Stealing_Pool::run_worker(size_t index) {
+	current_pool = this;
+	current_worker = index;
+	std::function<void()> task;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(state_mutex_);
+			work_available_.wait(lock, [this] { return queued_ > 0 || stopping_; });
+			if (queued_ == 0)
+				return;
+			// Claim one queued task; it is in some deque, try_pop below is guaranteed to find it.
+			--queued_;
+		}
+		while (!try_pop(index, task)) {
+			// The task was counted before it became visible to this worker, look again.
+			std::this_thread::yield();
+		}
+		task();
+		task = nullptr;
+
+		std::lock_guard<std::mutex> lock(state_mutex_);
+		if (--unfinished_ == 0)
+			all_done_.notify_all();
+	}
+}
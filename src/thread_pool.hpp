@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads with one task deque per worker.
+// A worker takes its own newest task first (good cache locality for follow-up work it submitted
+// itself) and, when its deque runs dry, steals the oldest task of another worker. Tasks submitted
+// from outside the pool are spread round robin over the workers.
+class Work_Stealing_Pool {
+public:
+	// A thread_count of 0 uses std::thread::hardware_concurrency().
+	explicit Work_Stealing_Pool(unsigned thread_count = 0);
+	// Finishes all queued tasks before joining the workers.
+	~Work_Stealing_Pool();
+
+	Work_Stealing_Pool(const Work_Stealing_Pool&) = delete;
+	Work_Stealing_Pool& operator=(const Work_Stealing_Pool&) = delete;
+
+	// Queue a task. Called from a worker, the task goes to that worker's own deque.
+	// Tasks must not throw, catch inside the task and store the error with the result instead.
+	void submit(std::function<void()> task);
+	// Block until every submitted task, including tasks submitted by tasks, has finished.
+	void wait_idle();
+
+	unsigned thread_count() const { return static_cast<unsigned>(workers_.size()); }
+
+private:
+	struct Task_Queue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	void run_worker(size_t index);
+	bool try_pop(size_t index, std::function<void()>& task);
+
+	std::vector<std::unique_ptr<Task_Queue>> queues_;
+	std::vector<std::thread> workers_;
+	std::mutex state_mutex_;
+	std::condition_variable work_available_;
+	std::condition_variable all_done_;
+	// Tasks queued but not yet taken, and tasks queued or running; both only change under state_mutex_.
+	size_t queued_ {0};
+	size_t unfinished_ {0};
+	bool stopping_ {false};
+	std::atomic<size_t> next_queue_ {0};
+};
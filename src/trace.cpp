@@ -0,0 +1,178 @@
+#include "trace.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Hardware events recorded per phase, in the order they are reported.
+struct Counter_Event {
+	const char* name;
+	uint64_t config;
+};
+
+#ifdef __linux__
+constexpr Counter_Event COUNTER_EVENTS[] {
+	{"cycles", PERF_COUNT_HW_CPU_CYCLES},
+	{"instructions", PERF_COUNT_HW_INSTRUCTIONS},
+	{"cache_misses", PERF_COUNT_HW_CACHE_MISSES},
+	{"branch_misses", PERF_COUNT_HW_BRANCH_MISSES},
+};
+#else
+constexpr Counter_Event COUNTER_EVENTS[] {
+	{"cycles", 0}, {"instructions", 0}, {"cache_misses", 0}, {"branch_misses", 0},
+};
+#endif
+constexpr int COUNTER_EVENT_COUNT = static_cast<int>(std::size(COUNTER_EVENTS));
+
+// Descriptors of the opened counters, -1 where the kernel refused (no PMU, perf_event_paranoid,
+// seccomp in containers, ...). Missing counters are reported as unavailable, the wall time always works.
+int counter_fds[COUNTER_EVENT_COUNT] {-1, -1, -1, -1};
+std::string program_name {"aoc"};
+
+Trace_Format parse_trace_format(std::string_view value) {
+	if (value.empty() || value == "text" || value == "1")
+		return Trace_Format::text;
+	if (value == "json")
+		return Trace_Format::json;
+	if (value == "off" || value == "0")
+		return Trace_Format::off;
+	throw std::runtime_error("Error: Unknown trace format '" + std::string(value) + "', expected text or json");
+}
+
+void open_counters() {
+#ifdef __linux__
+	for (int i = 0; i < COUNTER_EVENT_COUNT; ++i) {
+		perf_event_attr attributes;
+		std::memset(&attributes, 0, sizeof(attributes));
+		attributes.size = sizeof(attributes);
+		attributes.type = PERF_TYPE_HARDWARE;
+		attributes.config = COUNTER_EVENTS[i].config;
+		// User space only, which is all an unprivileged process may count with the default paranoia level.
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		// Threads started later add their counts when they exit: joined within the phase they are
+		// included, threads that outlive it are not.
+		attributes.inherit = 1;
+		// The counters can be multiplexed if the PMU runs short, the times let us scale the values back.
+		attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		counter_fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+	}
+#endif
+}
+
+// Current value of counter 'i' scaled for multiplexing, or UINT64_MAX if it is not available.
+uint64_t read_counter(int i) {
+#ifdef __linux__
+	if (counter_fds[i] < 0)
+		return UINT64_MAX;
+	uint64_t values[3];
+	if (read(counter_fds[i], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)))
+		return UINT64_MAX;
+	if (values[2] == 0)
+		return 0;
+	if (values[2] == values[1])
+		return values[0];
+	return static_cast<uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+#else
+	(void)i;
+	return UINT64_MAX;
+#endif
+}
+
+uint64_t now_ns() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+void configure_trace(int& argc, char* argv[]) {
+	Trace_Format format {Trace_Format::off};
+	if (const char* environment = std::getenv("AOC_TRACE"))
+		format = parse_trace_format(environment);
+
+	// Remove the trace arguments in place, keeping the order of the others.
+	int kept = (argc > 0) ? 1 : 0;
+	for (int i = kept; i < argc; ++i) {
+		std::string_view argument {argv[i]};
+		if (argument == "--trace")
+			format = Trace_Format::text;
+		else if (argument.starts_with("--trace="))
+			format = parse_trace_format(argument.substr(8));
+		else
+			argv[kept++] = argv[i];
+	}
+	argc = kept;
+	argv[argc] = nullptr;
+
+	if (argc > 0) {
+		std::string_view path {argv[0]};
+		size_t slash = path.find_last_of('/');
+		program_name = std::string(slash == std::string_view::npos ? path : path.substr(slash + 1));
+	}
+	if (format != Trace_Format::off)
+		open_counters();
+	active_trace_format = format;
+}
+
+void Scoped_Phase::begin() {
+	static_assert(COUNTERS == COUNTER_EVENT_COUNT, "one start value per counter event");
+	active_ = true;
+	// Counters first and the clock last, so reading the counters is not part of the phase time.
+	for (int i = 0; i < COUNTERS; ++i)
+		start_counters_[i] = read_counter(i);
+	start_ns_ = now_ns();
+}
+
+void Scoped_Phase::end() {
+	const uint64_t wall_ns = now_ns() - start_ns_;
+	uint64_t deltas[COUNTERS];
+	for (int i = 0; i < COUNTERS; ++i) {
+		const uint64_t current = read_counter(i);
+		deltas[i] = (current == UINT64_MAX || start_counters_[i] == UINT64_MAX) ? UINT64_MAX : current - start_counters_[i];
+	}
+
+	// Build the whole record first and write it with one call, so records of nested phases never interleave.
+	std::string record;
+	char number[32];
+	if (active_trace_format == Trace_Format::json) {
+		record = "{\"program\":\"" + program_name + "\",\"phase\":\"" + name_ + "\",\"wall_ns\":" + std::to_string(wall_ns);
+		for (int i = 0; i < COUNTERS; ++i) {
+			record += ",\"";
+			record += COUNTER_EVENTS[i].name;
+			record += "\":";
+			record += (deltas[i] == UINT64_MAX) ? "null" : std::to_string(deltas[i]);
+		}
+		record += "}\n";
+	}
+	else {
+		std::snprintf(number, sizeof(number), "%12.3f ms", static_cast<double>(wall_ns) / 1e6);
+		record = "[trace] " + program_name + " " + name_;
+		record.append(record.size() < 32 ? 32 - record.size() : 1, ' ');
+		record += number;
+		for (int i = 0; i < COUNTERS; ++i) {
+			record += "  ";
+			record += COUNTER_EVENTS[i].name;
+			record += ' ';
+			record += (deltas[i] == UINT64_MAX) ? "n/a" : std::to_string(deltas[i]);
+		}
+		if (deltas[0] != UINT64_MAX && deltas[1] != UINT64_MAX && deltas[0] > 0) {
+			std::snprintf(number, sizeof(number), "  ipc %.2f", static_cast<double>(deltas[1]) / static_cast<double>(deltas[0]));
+			record += number;
+		}
+		record += '\n';
+	}
+	std::fwrite(record.data(), 1, record.size(), stderr);
+}
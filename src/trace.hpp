@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#ifdef AOC_ALLOCATION_PROFILER
+#include "allocation_profiler.hpp"
+#endif
+
+// Per-phase instrumentation for the dayXX executables.
+// Tracing is off unless the AOC_TRACE environment variable is set to "text" or "json", or a
+// --trace / --trace=json argument is passed. Every finished phase then writes one record with its
+// wall time and, where perf_event_open is permitted, the cycles, instructions, cache misses and
+// branch misses it took to stderr, so the puzzle answers on stdout are unchanged. The counters
+// follow the calling thread; the counts of threads it starts are only added when those threads
+// exit, so workers still running at the end of a phase (thread pools, pipeline stages) are
+// missing or only partly counted. A disabled phase costs one branch on a global flag.
+
+enum class Trace_Format { off, text, json };
+
+// Set once by configure_trace and read by every phase.
+inline Trace_Format active_trace_format = Trace_Format::off;
+
+// Pick the trace format from AOC_TRACE and the arguments, and open the hardware counters.
+// --trace[=text|json] arguments are removed from argv so the day can parse the rest as before;
+// the command line takes precedence over the environment. Throws std::runtime_error on an
+// unknown format.
+void configure_trace(int& argc, char* argv[]);
+
+// Measures the scope it lives in and reports it as one phase when the scope ends.
+class Scoped_Phase {
+public:
+	// The allocation phase is entered after begin() and left before end(), so the records the
+	// tracer formats are not charged to the phase they describe.
+	explicit Scoped_Phase(const char* name) : name_(name) {
+		if (active_trace_format != Trace_Format::off)
+			begin();
+#ifdef AOC_ALLOCATION_PROFILER
+		previous_allocation_phase_ = enter_allocation_phase(name);
+#endif
+	}
+	~Scoped_Phase() {
+#ifdef AOC_ALLOCATION_PROFILER
+		leave_allocation_phase(previous_allocation_phase_);
+#endif
+		if (active_)
+			end();
+	}
+
+	Scoped_Phase(const Scoped_Phase&) = delete;
+	Scoped_Phase& operator=(const Scoped_Phase&) = delete;
+
+private:
+	static constexpr int COUNTERS = 4;
+
+	void begin();
+	void end();
+
+	const char* name_;
+	bool active_{false};
+	uint64_t start_ns_{0};
+	uint64_t start_counters_[COUNTERS]{};
+#ifdef AOC_ALLOCATION_PROFILER
+	int previous_allocation_phase_{0};
+#endif
+};
+
+// Run 'work' as one traced phase and pass its result through, e.g.
+//   auto data = trace_phase("load", [] { return load_input<int>("data/day01_input.txt"); });
+template <typename Work>
+decltype(auto) trace_phase(const char* name, Work&& work) {
+	Scoped_Phase phase(name);
+	return std::forward<Work>(work)();
+}
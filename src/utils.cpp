@@ -1,4 +1,6 @@
 #include "utils.hpp"
+#include "depth_kernels.hpp"
+#include "load_pipeline.hpp"
 #include <vector>
 #include <string>
 #include <fstream>
@@ -6,67 +8,213 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
-#include <cassert>
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <thread>
+#include <future>
+#include <bit>
+#include <unordered_set>
+#include <atomic>
 
 // Day 01
 // Function for solving first part of the puzzle:
 // Count how many times a measurement increases from the previous one.
+// The comparisons run in the SIMD kernel selected for this CPU (see depth_kernels.cpp).
 int count_increases_simple(const std::vector<int>& data){
-    int count {0};
-	// Procede only if there are at least two elements to compare.
-	if (data.size() >= 2) {
-		for (size_t i = 1; i < data.size(); ++i) {
-			// Compare current element with the previous one and increment count if there is an increase.
-            if (data[i-1] < data[i])
-                count++;
-		}
-	}
-    return count;
+	// Compare every element with the previous one: data[i] < data[i+1].
+	return static_cast<int>(count_increases_at_offset(data.data(), data.size(), 1));
 }
 // Function for solving second part of the puzzle:
 // Count how many times a measurement increases from the previous one, but for three-measurement-wide sliding window.
 int count_increases_sliding_window(const std::vector<int>& data){
-	int count {0};
-	// As before, procede only if there are at least two elements to compare, but this time we need 
-    // at least four elements to form two sliding windows.
-	if (data.size() >= 4) {
-		for (size_t i = 0; i + 3 < data.size(); ++i) {
-            // Elements in the middle of the slididing windows cancel out, so we only need to compare
-            // the first and the last elements of the windows (data[i+1] and data[i+2] are present in 
-            // both windows and thus do not affect the comparison).
-			if (data[i] < data[i+3]) ++count;
+	// Elements in the middle of the slididing windows cancel out, so we only need to compare
+	// the first and the last elements of the windows (data[i+1] and data[i+2] are present in 
+	// both windows and thus do not affect the comparison).
+	return static_cast<int>(count_increases_at_offset(data.data(), data.size(), 3));
+}
+
+// Function for any window width and any number of widths at once.
+std::vector<unsigned long long> count_window_increases(std::span<const int> data, std::span<const size_t> windows, unsigned thread_count){
+	// Measurements compared at all widths before the next block is started; 64 KiB stays in L2.
+	constexpr size_t WINDOW_BLOCKSIZE = 16384;
+	// Chunks smaller than this are not worth a thread of their own.
+	constexpr size_t MIN_CHUNKSIZE = 1 << 18;
+	for (size_t window : windows)
+		if (window == 0)
+			throw std::runtime_error("Error: a sliding window must hold at least one measurement");
+	std::vector<unsigned long long> counts(windows.size(), 0);
+	if (windows.empty() || data.size() <= 1)
+		return counts;
+
+	// Count the comparisons that start in [begin, end) for every width. A comparison starting at i
+	// reads data[i + window], so a chunk reads up to 'window' measurements past its end.
+	auto count_chunk = [&](size_t begin, size_t end){
+		std::vector<unsigned long long> partial(windows.size(), 0);
+		for (size_t block = begin; block < end; block += WINDOW_BLOCKSIZE){
+			const size_t block_end = std::min(end, block + WINDOW_BLOCKSIZE);
+			for (size_t w = 0; w < windows.size(); ++w){
+				if (block + windows[w] >= data.size())
+					continue;
+				const size_t last = std::min(block_end, data.size() - windows[w]);
+				partial[w] += count_increases_at_offset(data.data() + block, last - block + windows[w], windows[w]);
+			}
 		}
+		return partial;
+	};
+
+	// Every comparison starts below data.size() - 1, whatever the width.
+	const size_t starts = data.size() - 1;
+	if (thread_count == 0)
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	const size_t chunk_count = std::min<size_t>(thread_count, starts / MIN_CHUNKSIZE + 1);
+	const size_t chunk_size = (starts + chunk_count - 1) / chunk_count;
+	std::vector<std::future<std::vector<unsigned long long>>> pending;
+	for (size_t c = 1; c < chunk_count; ++c)
+		pending.push_back(std::async(std::launch::async, count_chunk, std::min(starts, c * chunk_size), std::min(starts, (c + 1) * chunk_size)));
+	counts = count_chunk(0, std::min(starts, chunk_size));
+	for (auto& future : pending){
+		std::vector<unsigned long long> partial = future.get();
+		for (size_t w = 0; w < windows.size(); ++w)
+			counts[w] += partial[w];
+	}
+	return counts;
+}
+unsigned long long count_window_increases(std::span<const int> data, size_t window, unsigned thread_count){
+	return count_window_increases(data, std::span<const size_t>(&window, 1), thread_count).front();
+}
+
+// Function for the streaming mode of the puzzle:
+// Parse measurements chunk by chunk from a descriptor. A number split across two reads is carried over
+// to the front of the buffer, so the only allocation is the fixed size read buffer itself.
+void stream_depth_measurements(int fd, Depth_Increase_Counter& counter,
+		const std::function<void(const Depth_Increase_Counter&)>& on_chunk){
+	constexpr size_t CHUNKSIZE = 1 << 16;
+	std::vector<char> buffer(CHUNKSIZE);
+	size_t carried {0};
+	auto is_space = [](char c){ return c == ' ' || (c >= '\t' && c <= '\r'); };
+
+	while (true) {
+		ssize_t bytes_read = ::read(fd, buffer.data() + carried, buffer.size() - carried);
+		if (bytes_read < 0) {
+			if (errno == EINTR)
+				continue;
+			throw std::runtime_error(std::string("Error: failed to read measurements: ") + std::strerror(errno));
+		}
+		bool end_of_feed = (bytes_read == 0);
+		size_t filled = carried + static_cast<size_t>(bytes_read);
+
+		// Unless the feed has ended, the characters after the last whitespace may be an incomplete number.
+		size_t parse_end = filled;
+		if (!end_of_feed)
+			while (parse_end > 0 && !is_space(buffer[parse_end - 1]))
+				--parse_end;
+
+		const char* current = buffer.data();
+		const char* const end = buffer.data() + parse_end;
+		while (true) {
+			while (current != end && is_space(*current))
+				++current;
+			if (current == end)
+				break;
+			int measurement;
+			auto [next, error] = std::from_chars(current, end, measurement);
+			// Throw an exception if the token is not a number or has trailing garbage.
+			if (error != std::errc() || (next != end && !is_space(*next))) {
+				const char* token_end = current;
+				while (token_end != end && !is_space(*token_end))
+					++token_end;
+				throw std::runtime_error("Error: invalid measurement: " + std::string(current, token_end));
+			}
+			counter.push(measurement);
+			current = next;
+		}
+
+		// Move the incomplete tail to the front of the buffer for the next read.
+		carried = filled - parse_end;
+		if (carried == buffer.size())
+			throw std::runtime_error("Error: measurement does not fit in the read buffer");
+		std::memmove(buffer.data(), buffer.data() + parse_end, carried);
+
+		if (on_chunk)
+			on_chunk(counter);
+		if (end_of_feed)
+			break;
 	}
-    return count;
 }
 
 // Day 02
+// Error path of parse_submarine_command, kept out of line so the hot path stays small.
+[[noreturn]] static void throw_invalid_command(std::string_view line, bool value_missing){
+	auto is_space = [](char c){ return c == ' ' || (c >= '\t' && c <= '\r'); };
+	if (value_missing)
+		throw std::runtime_error("Error: invalid input line: " + std::string(line));
+	size_t command_start {0};
+	while (command_start < line.size() && is_space(line[command_start]))
+		++command_start;
+	size_t command_end {command_start};
+	while (command_end < line.size() && !is_space(line[command_end]))
+		++command_end;
+	throw std::runtime_error("Error: unknown command: " + std::string(line.substr(command_start, command_end - command_start)));
+}
+
+// Function to parse a single command line straight from its bytes without allocating.
+// The parsing follows 'line_stream >> command >> value': leading whitespace is skipped, the command
+// is the first word and anything after the value is ignored. The keyword is dispatched on its first
+// letter, so only one short comparison is needed per line.
+Submarine_Command parse_submarine_command(std::string_view line){
+	auto is_space = [](char c){ return c == ' ' || (c >= '\t' && c <= '\r'); };
+	const char* current = line.data();
+	const char* const end = line.data() + line.size();
+
+	while (current != end && is_space(*current))
+		++current;
+	if (current == end)
+		throw_invalid_command(line, true);
+
+	Submarine_Command parsed;
+	std::string_view keyword;
+	switch (*current){
+		case 'f': parsed.direction = Submarine_Direction::forward; keyword = "forward"; break;
+		case 'd': parsed.direction = Submarine_Direction::down;    keyword = "down";    break;
+		case 'u': parsed.direction = Submarine_Direction::up;      keyword = "up";      break;
+		default: keyword = {}; break;
+	}
+	// The keyword has to match completely and be followed by whitespace, otherwise the first word is
+	// an unknown command (reported after the value check, like the stream based parsing did).
+	bool known = !keyword.empty() && static_cast<size_t>(end - current) > keyword.size()
+		&& std::memcmp(current, keyword.data(), keyword.size()) == 0 && is_space(current[keyword.size()]);
+	if (known)
+		current += keyword.size();
+	else
+		while (current != end && !is_space(*current))
+			++current;
+
+	while (current != end && is_space(*current))
+		++current;
+	if (current != end && *current == '+')
+		++current;
+	auto [value_end, error] = std::from_chars(current, end, parsed.value);
+	if (error != std::errc() || !known)
+		throw_invalid_command(line, error != std::errc());
+	return parsed;
+}
+
 // Function to calculate the first part of the puzzle:
 // Calculate the final horizontal position and depth based on movement commands.
-int calculate_final_position(const std::vector<std::string>& data){
-	int x{0}, y{0};	
-
-	// Iterate through each line of input data to separate commands and their values.
-	for(const std::string& line : data){
-		std::string command;
-		int value;
-		std::istringstream line_stream(line);
-		
-		line_stream >> command >> value;
-		// In case of input error the failbit is set so we check the stream state and throw an exception if needed.
-		if (line_stream.fail()) {
-			throw std::runtime_error("Error: invalid input line: " + line);
-		}
-		
-		// Process each command accordingly and throw an exception if an unknown command is encountered.
-		if (command == "forward"){
-			x += value;
-		} else if (command == "down"){
-			y += value;
-		} else if (command == "up"){
-			y -= value;
-		} else {
-			throw std::runtime_error("Error: unknown command: " + command);
+// Shared by the overloads for owned strings and for views into a Line_Buffer.
+template <typename Lines>
+static long long final_position(const Lines& data){
+	long long x{0}, y{0};	
+
+	// Iterate through each line of input data, parse_submarine_command throws for invalid lines.
+	for(std::string_view line : data){
+		Submarine_Command command {parse_submarine_command(line)};
+		switch (command.direction){
+			case Submarine_Direction::forward: x += command.value; break;
+			case Submarine_Direction::down:    y += command.value; break;
+			case Submarine_Direction::up:      y -= command.value; break;
 		}
 	}
 
@@ -74,39 +222,134 @@ int calculate_final_position(const std::vector<std::string>& data){
 	return x * y;
 }
 
+long long calculate_final_position(const std::vector<std::string>& data){
+	return final_position(data);
+}
+long long calculate_final_position(std::span<const std::string_view> data){
+	return final_position(data);
+}
+
 // Function to calculate the second part of the puzzle:
 // Calculate the final horizontal position and depth based on movement commands with aim adjustment.
-int calculate_final_position_with_aim(const std::vector<std::string>& data){
-	int x{0}, y{0}, aim{0};	
-
-	// Iterate through each line of input data to separate commands and their values.
-	for(const std::string& line : data){
-		std::string command;
-		int value;
-		std::istringstream line_stream(line);
-
-		line_stream >> command >> value;
-		// In case of input error the failbit is set so we check the stream state and throw an exception if needed.
-		if (line_stream.fail()) {
-			throw std::runtime_error("Error: invalid input line: " + line);
-		}
+template <typename Lines>
+static long long final_position_with_aim(const Lines& data){
+	long long x{0}, y{0}, aim{0};	
 
-		// Process each command accordingly and throw an exception if an unknown command is encountered.
-		if (command == "forward"){
-			x += value;
-			y += aim * value;
-		} else if (command == "down"){
-			aim += value;
-		} else if (command == "up"){
-			aim -= value;
-		} else {
-			throw std::runtime_error("Error: unknown command: " + command);
+	// Iterate through each line of input data, parse_submarine_command throws for invalid lines.
+	for(std::string_view line : data){
+		Submarine_Command command {parse_submarine_command(line)};
+		switch (command.direction){
+			case Submarine_Direction::forward:
+				x += command.value;
+				y += aim * command.value;
+				break;
+			case Submarine_Direction::down: aim += command.value; break;
+			case Submarine_Direction::up:   aim -= command.value; break;
 		}
 	}
 
 	// Return the product of the final horizontal position and depth.
 	return x * y;
 }
+long long calculate_final_position_with_aim(const std::vector<std::string>& data){
+	return final_position_with_aim(data);
+}
+long long calculate_final_position_with_aim(std::span<const std::string_view> data){
+	return final_position_with_aim(data);
+}
+
+// Summary of 'first' followed by 'second': the aim accumulated in 'first' is the incoming aim of 'second',
+// so every forward step of 'second' gets 'first.aim_change' extra depth.
+Course_Segment combine_course_segments(const Course_Segment& first, const Course_Segment& second){
+	Course_Segment combined;
+	combined.forward = first.forward + second.forward;
+	combined.aim_change = first.aim_change + second.aim_change;
+	combined.depth_at_zero_aim = first.depth_at_zero_aim + second.depth_at_zero_aim + first.aim_change * second.forward;
+	return combined;
+}
+
+// Summarize one chunk of the raw command log, one parse_submarine_command call per line.
+static Course_Segment summarize_course_chunk(std::string_view chunk){
+	Course_Segment segment;
+	const char* current = chunk.data();
+	const char* const end = chunk.data() + chunk.size();
+	while (current != end) {
+		const char* newline = static_cast<const char*>(std::memchr(current, '\n', static_cast<size_t>(end - current)));
+		const char* line_end = (newline == nullptr) ? end : newline;
+		Submarine_Command command {parse_submarine_command(std::string_view(current, static_cast<size_t>(line_end - current)))};
+		current = (newline == nullptr) ? end : newline + 1;
+
+		// Branch free update, the command order in real logs is too irregular to predict.
+		long long forward = (command.direction == Submarine_Direction::forward) ? command.value : 0;
+		long long aim_change = (command.direction == Submarine_Direction::down) ? command.value
+			: (command.direction == Submarine_Direction::up) ? -command.value : 0;
+		segment.forward += forward;
+		segment.depth_at_zero_aim += segment.aim_change * forward;
+		segment.aim_change += aim_change;
+	}
+	return segment;
+}
+
+// Function to calculate both parts of the puzzle in a single parallel pass.
+Course_Result calculate_final_positions_parallel(std::string_view commands, unsigned thread_count){
+	// Chunks smaller than this are not worth a thread of their own.
+	constexpr size_t MIN_CHUNKSIZE = 1 << 20;
+	if (thread_count == 0)
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	size_t chunk_count = std::min<size_t>(thread_count, commands.size() / MIN_CHUNKSIZE + 1);
+
+	// Cut the log into roughly equal chunks, moving every cut forward to just after a newline
+	// so that no command is split between two chunks.
+	std::vector<std::string_view> chunks;
+	size_t chunk_start {0};
+	for (size_t i = 1; i <= chunk_count && chunk_start < commands.size(); ++i) {
+		size_t chunk_end = commands.size();
+		if (i < chunk_count) {
+			chunk_end = std::max(chunk_start, commands.size() / chunk_count * i);
+			chunk_end = commands.find('\n', chunk_end);
+			chunk_end = (chunk_end == std::string_view::npos) ? commands.size() : chunk_end + 1;
+		}
+		chunks.push_back(commands.substr(chunk_start, chunk_end - chunk_start));
+		chunk_start = chunk_end;
+	}
+
+	// Summarize the chunks concurrently, the futures rethrow any parsing error on get().
+	std::vector<std::future<Course_Segment>> pending;
+	for (size_t i = 1; i < chunks.size(); ++i)
+		pending.push_back(std::async(std::launch::async, summarize_course_chunk, chunks[i]));
+	std::vector<Course_Segment> segments;
+	segments.push_back(chunks.empty() ? Course_Segment{} : summarize_course_chunk(chunks.front()));
+	for (auto& future : pending)
+		segments.push_back(future.get());
+
+	// Merge neighbouring summaries pairwise until one is left (log2(chunks) rounds).
+	while (segments.size() > 1) {
+		std::vector<Course_Segment> merged;
+		for (size_t i = 0; i + 1 < segments.size(); i += 2)
+			merged.push_back(combine_course_segments(segments[i], segments[i + 1]));
+		if (segments.size() % 2 == 1)
+			merged.push_back(segments.back());
+		segments.swap(merged);
+	}
+
+	// Part 1 depth is the plain sum of downs and ups, which is exactly the aim of part 2.
+	const Course_Segment& course = segments.front();
+	return Course_Result{course.forward * course.aim_change, course.forward * course.depth_at_zero_aim};
+}
+
+// Function to calculate both parts of the puzzle from parsed commands, same arithmetic as a single chunk.
+Course_Result calculate_final_positions(std::span<const Submarine_Command> commands){
+	Course_Segment course;
+	for (const Submarine_Command& command : commands) {
+		long long forward = (command.direction == Submarine_Direction::forward) ? command.value : 0;
+		long long aim_change = (command.direction == Submarine_Direction::down) ? command.value
+			: (command.direction == Submarine_Direction::up) ? -command.value : 0;
+		course.forward += forward;
+		course.depth_at_zero_aim += course.aim_change * forward;
+		course.aim_change += aim_change;
+	}
+	return Course_Result{course.forward * course.aim_change, course.forward * course.depth_at_zero_aim};
+}
 
 // Day 03
 // Function to convert a binary string to its integer representation.
@@ -116,26 +359,76 @@ int binary_str_to_int(const std::string& str) {
 	return std::stoi(str, nullptr, 2);
 }
 
-// Function to calculate the first part of the puzzle:
-// Calculate the product of gamma rate and epsilon rate from vector of binary data strings.
-unsigned long long calculate_gamma_epsilon_product(const std::vector<std::string>& data) {
-	// n = number of lines in dataset
-	// m = number of bits per line
-	size_t n = data.size();
-	size_t m = data.front().size();
+// Function to transpose the binary strings into bit columns.
+// Rows are processed in blocks of 64: the current word of every column is assembled in a small
+// row-sized buffer first, so the strings are read in order and every column word is written once.
+template <typename Lines>
+static Bit_Columns transpose_to_bit_columns(const Lines& data) {
+	Bit_Columns columns;
+	if (data.empty())
+		return columns;
+	columns.width = data.front().size();
+	columns.rows = data.size();
+	columns.words_per_column = (data.size() + 63) / 64;
+	columns.words.assign(columns.width * columns.words_per_column, 0);
+
+	std::vector<uint64_t> block(columns.width);
+	for (size_t word = 0; word < columns.words_per_column; ++word) {
+		std::fill(block.begin(), block.end(), 0);
+		size_t block_end = std::min(data.size(), (word + 1) * 64);
+		for (size_t row = word * 64; row < block_end; ++row) {
+			std::string_view s = data[row];
+			// Throw an exception if the rows do not all have the same number of bits.
+			if (s.size() != columns.width)
+				throw std::runtime_error("Error: diagnostic row has a different width: " + std::string(s));
+			// Shift the comparison result instead of selecting with '?:', which a profile guided build
+			// turns into a branch that mispredicts on every other random bit.
+			const unsigned shift = static_cast<unsigned>(row % 64);
+			for (size_t i = 0; i < columns.width; ++i)
+				block[i] |= static_cast<uint64_t>(s[i] == '1') << shift;
+		}
+		for (size_t i = 0; i < columns.width; ++i)
+			columns.words[i * columns.words_per_column + word] = block[i];
+	}
+	return columns;
+}
+Bit_Columns build_bit_columns(const std::vector<std::string>& data) {
+	return transpose_to_bit_columns(data);
+}
+Bit_Columns build_bit_columns(std::span<const std::string_view> data) {
+	return transpose_to_bit_columns(data);
+}
 
-	// Vector 'ones' to count number of '1's in each bit position (size 'm', initialized to 0).
-	std::vector<int> ones(m, 0);
-	for (const auto &s : data)
-		for (size_t i = 0; i < m; ++i)
-			ones[i] += (s[i] == '1');
+// Number of rows with a '1' at the given position, one hardware popcount per 64 rows.
+size_t Bit_Columns::count_ones(size_t position) const {
+	size_t ones {0};
+	const uint64_t* bits = column(position);
+	for (size_t word = 0; word < words_per_column; ++word)
+		ones += static_cast<size_t>(std::popcount(bits[word]));
+	return ones;
+}
+
+// Function to build the gamma rate of any width: if ones > n/2, the most common bit is '1'.
+std::string most_common_bits(const Bit_Columns& columns) {
+	std::string gamma(columns.width, '0');
+	for (size_t i = 0; i < columns.width; ++i)
+		if (columns.count_ones(i) > columns.rows / 2)
+			gamma[i] = '1';
+	return gamma;
+}
+
+// Function to calculate the first part of the puzzle:
+// Calculate the product of gamma rate and epsilon rate from the bit columns of the binary data strings.
+static unsigned long long gamma_epsilon_product(const Bit_Columns& columns) {
+	// The product is returned as a 64-bit number, wider reports can use most_common_bits() directly.
+	if (columns.width > 64)
+		throw std::overflow_error("Error: gamma and epsilon rates do not fit in 64 bits");
 
 	// gamma: most common bit in each position across all input lines.
 	// epsilon: bitwise inverse of gamma (least common bit in each position).
 	unsigned long long gamma = 0, epsilon = 0;
-	// For each position: if ones > n/2, the most common bit is '1'.
-	for (size_t i = 0; i < m; ++i) {
-		bool most_common_is_one = (ones[i] > n / 2);
+	for (size_t i = 0; i < columns.width; ++i) {
+		bool most_common_is_one = (columns.count_ones(i) > columns.rows / 2);
 		// Build gamma and epsilon by shifting left and adding the new bit (the '<< 1' operation),
 		// then setting the least significant bit according to the most common bit ( '| ...' operation).
 		gamma = (gamma << 1) | (most_common_is_one ? 1ULL : 0ULL);
@@ -145,80 +438,126 @@ unsigned long long calculate_gamma_epsilon_product(const std::vector<std::string
 
 	return gamma * epsilon;
 }
+unsigned long long calculate_gamma_epsilon_product(const std::vector<std::string>& data) {
+	return data.empty() ? 0 : gamma_epsilon_product(build_bit_columns(data));
+}
+unsigned long long calculate_gamma_epsilon_product(std::span<const std::string_view> data) {
+	return data.empty() ? 0 : gamma_epsilon_product(build_bit_columns(data));
+}
+
+// Function to pack the rows of the bit columns into sorted integers.
+Sorted_Diagnostic_Index build_sorted_index(const Bit_Columns& columns) {
+	if (columns.width > 64)
+		throw std::overflow_error("Error: diagnostic rows do not fit in 64 bits");
+	Sorted_Diagnostic_Index index;
+	index.width = columns.width;
+	index.values.assign(columns.rows, 0);
+	// Shift in one column at a time, starting with the most significant position.
+	for (size_t i = 0; i < columns.width; ++i) {
+		const uint64_t* bits = columns.column(i);
+		for (size_t row = 0; row < columns.rows; ++row)
+			index.values[row] = (index.values[row] << 1) | ((bits[row / 64] >> (row % 64)) & 1);
+	}
+	std::sort(index.values.begin(), index.values.end());
+	return index;
+}
+
+// Function to find either oxygen generator rating or CO2 scrubber rating.
+// The remaining candidates are always the range [first, last) of the sorted values: they share all
+// bits already decided, so the rows with a '0' at the current position come before those with a '1'.
+unsigned long long find_rating(std::span<const uint64_t> sorted_values, size_t width, bool keep_most_common) {
+	if (sorted_values.empty())
+		throw std::runtime_error("Error: no diagnostic rows to rate");
+	auto first = sorted_values.begin();
+	auto last = sorted_values.end();
+	for (size_t pos = 0; pos < width && last - first > 1; ++pos) {
+		const uint64_t mask = uint64_t{1} << (width - 1 - pos);
+		auto first_one = std::partition_point(first, last, [mask](uint64_t value){ return (value & mask) == 0; });
+		auto ones = last - first_one;
+		auto zeros = first_one - first;
 
+		// Decide which bit to keep:
+		// - most common: keep the most common bit; if tied, keep '1'.
+		// - least common: keep the least common bit; if tied, keep '0'.
+		// A bit no remaining candidate has cannot be kept, the other one is kept instead.
+		bool keep_one = keep_most_common ? (ones >= zeros) : (zeros > ones);
+		if (ones == 0 || zeros == 0)
+			keep_one = (ones != 0);
+		if (keep_one)
+			first = first_one;
+		else
+			last = first_one;
+	}
+	// The remaining candidates are identical, so the first one is the rating.
+	return *first;
+}
+unsigned long long find_rating(const Sorted_Diagnostic_Index& index, bool keep_most_common) {
+	return find_rating(index.values, index.width, keep_most_common);
+}
+
+// Function to calculate the second part of the puzzle:
+// Multiply oxygen generator rating (most-common filter) by CO2 scrubber rating (least-common filter).
 unsigned long long calculate_life_support_rating(const std::vector<std::string>& data) {
-	// Helper lambda function 'find rate' to find either oxygen generator rating or CO2 scrubber rating based on mode.
-	// mode == '1' for oxygen generator rating (most common bit criteria)
-	// mode == '0' for CO2 scrubber rating (least common bit criteria)
-	auto find_rate = [&](char mode) -> unsigned long long {
-		// Maintain a list of indices into `data` to avoid copying strings
-		std::vector<int> idx(data.size());
-		// Initialize indices to all entries in data.
-		for (size_t i = 0; i < idx.size(); ++i) 
-			// static_cast to convert size_t to int safely
-			idx[i] = static_cast<int>(i);
-		// 'm' is the number of bits in each binary string.
-		size_t m = data.front().size(); 
-
-		// For each bit position, compute counts among remaining candidates and filter.
-		for (size_t pos = 0; pos < m && idx.size() > 1; ++pos) {
-			// Count how many remaining candidates have '1' at this position.
-			int ones = 0;
-			for (int id : idx) if (data[id][pos] == '1') ++ones;
-			int zeros = static_cast<int>(idx.size()) - ones;
-
-			// Decide which bit to keep based on mode:
-			// - mode == '1': keep the most common bit; if tied, keep '1'.
-			// - mode == '0': keep the least common bit; if tied, keep '0'.
-			char keep;
-			if (mode == '1') keep = (ones >= zeros) ? '1' : '0';
-			else             keep = (zeros <= ones) ? '0' : '1';
-
-			// Build the next list of candidate indices that have the desired bit.
-			std::vector<int> next;
-			next.reserve(idx.size());
-			for (int id : idx)
-				if (data[id][pos] == keep)
-					next.push_back(id);
-
-			// Replace current candidate list with the filtered one.
-			idx.swap(next);
-		}
+	Sorted_Diagnostic_Index index {build_sorted_index(build_bit_columns(data))};
+	return find_rating(index, true) * find_rating(index, false);
+}
+unsigned long long calculate_life_support_rating(std::span<const std::string_view> data) {
+	Sorted_Diagnostic_Index index {build_sorted_index(build_bit_columns(data))};
+	return find_rating(index, true) * find_rating(index, false);
+}
+unsigned long long calculate_life_support_rating(std::span<const uint64_t> sorted_values, size_t width) {
+	return find_rating(sorted_values, width, true) * find_rating(sorted_values, width, false);
+}
 
-		// When only one candidate remains, convert its binary string to integer.
-		return binary_str_to_int(data[idx.front()]);
-	};
+// Function to calculate the first part of the puzzle from packed rows: the '1's of every position
+// are counted with a shift and mask per row, the order of the rows does not matter here.
+unsigned long long calculate_gamma_epsilon_product(std::span<const uint64_t> sorted_values, size_t width) {
+	if (width > 64)
+		throw std::overflow_error("Error: gamma and epsilon rates do not fit in 64 bits");
+	if (sorted_values.empty())
+		return 0;
+	std::array<size_t, 64> ones {};
+	for (uint64_t value : sorted_values)
+		for (size_t i = 0; i < width; ++i)
+			ones[i] += (value >> (width - 1 - i)) & 1;
 
-	// Multiply oxygen generator rating (most-common filter) by CO2 scrubber rating (least-common filter).
-	return find_rate('1') * find_rate('0');
+	unsigned long long gamma = 0, epsilon = 0;
+	for (size_t i = 0; i < width; ++i) {
+		bool most_common_is_one = (ones[i] > sorted_values.size() / 2);
+		gamma = (gamma << 1) | static_cast<unsigned long long>(most_common_is_one);
+		epsilon = (epsilon << 1) | static_cast<unsigned long long>(!most_common_is_one);
+	}
+	return gamma * epsilon;
 }
 
 // Day 04
 
-// Marks the called number on the bingo board if present by replacing it with -1
-// and updating the horizontal and vertical line counters keeping track of marked numbers.
-// Function exits after marking the first occurrence of the called number as there are no 
+// Marks the called number on the bingo board if present by setting its bit in the marked mask,
+// the cell values themselves are never overwritten.
+// Function exits after marking the first unmarked occurrence of the called number as there are no 
 // duplicate numbers on a bingo board.
 void Bingo_Board::mark_number(int called_number){
-	for (auto& row : contents){
-		for (auto& cell : row){
-			if (cell == called_number){
-				cell = -1;
-				// Update the counters for the corresponding row and column.
-				// '&row - &contents[0]' and '&cell - &row[0]' calculate the indices
-				// using pointer arithmetic.			
-				horizontal_lines[&row - &contents[0]] += 1;
-				vertical_lines[&cell - &row[0]] += 1;
-				return;
-			}
+	for (int cell = 0; cell < BOARDSIZE * BOARDSIZE; ++cell){
+		if (!is_marked(cell / BOARDSIZE, cell % BOARDSIZE) && contents[cell / BOARDSIZE][cell % BOARDSIZE] == called_number){
+			marked |= uint32_t{1} << cell;
+			return;
 		}
 	}
 }
 
+// Marks a single (unmarked) cell found through the number index.
+// Returns true if this mark completed its row or its column.
+bool Bingo_Board::mark_cell(int row, int column){
+	marked |= uint32_t{1} << (row * BOARDSIZE + column);
+	const uint32_t row_mask = BINGO_LINE_MASKS[row];
+	const uint32_t column_mask = BINGO_LINE_MASKS[BOARDSIZE + column];
+	return (marked & row_mask) == row_mask || (marked & column_mask) == column_mask;
+}
+
 // Checks if any horizontal or vertical line on the bingo board is fully marked.
-bool Bingo_Board::any_line_marked(){
-	for (int i = 0 ; i < BOARDSIZE ; i++){
-		if ((horizontal_lines[i] == BOARDSIZE) || (vertical_lines[i] == BOARDSIZE))
+bool Bingo_Board::any_line_marked() const{
+	for (uint32_t line_mask : BINGO_LINE_MASKS){
+		if ((marked & line_mask) == line_mask)
 			return true;
 	}
 	return false;
@@ -226,13 +565,11 @@ bool Bingo_Board::any_line_marked(){
 
 // Calculates the score of the bingo board by summing all unmarked numbers
 // and multiplying the sum by the last called number as per puzzle rules.
-int Bingo_Board::calculate_score(int called_number){
+int Bingo_Board::calculate_score(int called_number) const{
 	int unmarked_sum {0};
-	for (auto& row : contents){
-		for (auto& cell : row){
-			if (cell != -1)
-				unmarked_sum += cell;
-		}
+	for (int cell = 0; cell < BOARDSIZE * BOARDSIZE; ++cell){
+		if (!is_marked(cell / BOARDSIZE, cell % BOARDSIZE))
+			unmarked_sum += contents[cell / BOARDSIZE][cell % BOARDSIZE];
 	}
 	return unmarked_sum * called_number;
 }
@@ -271,6 +608,51 @@ std::vector<Bingo_Board> load_bingo_boards(std::istream& input_file) {
 	return boards;
 }
 
+// Occurrences of a number, empty for numbers that are on no board.
+std::span<const Bingo_Cell_Ref> Bingo_Number_Index::occurrences(int number) const{
+	if (number < 0 || static_cast<size_t>(number) + 1 >= offsets.size())
+		return {};
+	return std::span<const Bingo_Cell_Ref>(cells.data() + offsets[number], offsets[number + 1] - offsets[number]);
+}
+
+// Build the number index with a counting pass and a filling pass over all cells.
+// Negative numbers are left out, as they can never be called.
+Bingo_Number_Index build_bingo_index(const std::vector<Bingo_Board>& boards){
+	int max_number {-1};
+	for (const auto& board : boards)
+		for (const auto& row : board.contents)
+			for (int cell : row)
+				max_number = std::max(max_number, cell);
+
+	Bingo_Number_Index index;
+	index.offsets.assign(static_cast<size_t>(max_number) + 2, 0);
+	auto for_each_cell = [&](auto&& visit){
+		for (size_t b = 0; b < boards.size(); ++b)
+			for (int r = 0; r < BOARDSIZE; ++r)
+				for (int c = 0; c < BOARDSIZE; ++c)
+					if (boards[b].contents[r][c] >= 0)
+						visit(boards[b].contents[r][c], Bingo_Cell_Ref{static_cast<uint32_t>(b), static_cast<uint8_t>(r), static_cast<uint8_t>(c)});
+	};
+
+	// Count the occurrences of every number and turn the counts into starting offsets.
+	for_each_cell([&](int number, const Bingo_Cell_Ref&){ ++index.offsets[number + 1]; });
+	for (size_t n = 1; n < index.offsets.size(); ++n)
+		index.offsets[n] += index.offsets[n - 1];
+
+	// Fill in the cells. Boards are visited in order, so every list is sorted by board and,
+	// within a board, in the same row-major order mark_number scans the cells.
+	index.cells.resize(index.offsets.back());
+	std::vector<uint32_t> next(index.offsets.begin(), index.offsets.end() - 1);
+	for_each_cell([&](int number, const Bingo_Cell_Ref& cell){ index.cells[next[number]++] = cell; });
+	return index;
+}
+
+std::vector<Bingo_Board> load_bingo_boards(std::istream& input_file, Bingo_Number_Index& index) {
+	std::vector<Bingo_Board> boards = load_bingo_boards(input_file);
+	index = build_bingo_index(boards);
+	return boards;
+}
+
 // Function to calculate the score of the first winning bingo board.
 int calculate_bingo_first_winner_score(const std::vector<int>& bingo_sequence, std::vector<Bingo_Board>& boards) {
 	for (auto& called_number : bingo_sequence) {
@@ -312,6 +694,361 @@ int calculate_bingo_last_winner_score(const std::vector<int>& bingo_sequence, st
 	return last_score;
 }
 
+// Boards with a complete line before the first call. They only occur when the boards were already
+// played (e.g. part 2 after part 1) and win on the first call, just like with the full board scan.
+static std::vector<uint32_t> boards_already_won(const std::vector<Bingo_Board>& boards){
+	std::vector<uint32_t> won;
+	for (size_t b = 0; b < boards.size(); ++b)
+		if (boards[b].any_line_marked())
+			won.push_back(static_cast<uint32_t>(b));
+	return won;
+}
+
+// Function to calculate the score of the first winning bingo board using the number index.
+// Within a turn the board scan returns the first winner in board order, so the lowest index wins here.
+int calculate_bingo_first_winner_score(const std::vector<int>& bingo_sequence, std::vector<Bingo_Board>& boards, const Bingo_Number_Index& index) {
+	std::vector<uint32_t> pre_won = boards_already_won(boards);
+	for (size_t turn = 0; turn < bingo_sequence.size(); ++turn) {
+		int called_number = bingo_sequence[turn];
+		uint32_t winner = (turn == 0 && !pre_won.empty()) ? pre_won.front() : UINT32_MAX;
+		uint32_t marked_board = UINT32_MAX;
+		for (const Bingo_Cell_Ref& cell : index.occurrences(called_number)) {
+			// The board scan stops marking at the winner, boards after it are left untouched.
+			if (cell.board > winner)
+				break;
+			// Like mark_number, mark only the first unmarked occurrence on each board.
+			if (cell.board == marked_board || boards[cell.board].is_marked(cell.row, cell.column))
+				continue;
+			marked_board = cell.board;
+			if (boards[cell.board].mark_cell(cell.row, cell.column))
+				winner = std::min(winner, cell.board);
+		}
+		if (winner != UINT32_MAX)
+			return boards[winner].calculate_score(called_number);
+	}
+	// In case there is no winning board (which should not happen in a valid input), throw a runtime error.
+	throw std::runtime_error("No winning board found in the provided sequence.");
+}
+
+// Function to calculate the score of the last winning bingo board using the number index.
+// Boards that have won are skipped instead of erased; within a turn the last winner in board
+// order provides the score, as with the board scan.
+int calculate_bingo_last_winner_score(const std::vector<int>& bingo_sequence, std::vector<Bingo_Board>& boards, const Bingo_Number_Index& index) {
+	std::vector<bool> won(boards.size(), false);
+	std::vector<uint32_t> pre_won = boards_already_won(boards);
+
+	int last_score = -1;
+	for (size_t turn = 0; turn < bingo_sequence.size(); ++turn) {
+		int called_number = bingo_sequence[turn];
+		int64_t last_winner = (turn == 0 && !pre_won.empty()) ? static_cast<int64_t>(pre_won.back()) : -1;
+		uint32_t marked_board = UINT32_MAX;
+		for (const Bingo_Cell_Ref& cell : index.occurrences(called_number)) {
+			// Like mark_number, mark only the first unmarked occurrence on each board.
+			if (won[cell.board] || cell.board == marked_board || boards[cell.board].is_marked(cell.row, cell.column))
+				continue;
+			marked_board = cell.board;
+			if (boards[cell.board].mark_cell(cell.row, cell.column)) {
+				won[cell.board] = true;
+				last_winner = std::max<int64_t>(last_winner, cell.board);
+			}
+		}
+		// Boards that had already won are still marked with the first call before they drop out.
+		if (turn == 0)
+			for (uint32_t board : pre_won)
+				won[board] = true;
+		if (last_winner != -1)
+			last_score = boards[last_winner].calculate_score(called_number);
+	}
+	if (last_score == -1) {
+		// If last_score was never updated, it means no board won. Throw a runtime error.
+		throw std::runtime_error("No winning board found in the provided sequence.");
+	}
+	return last_score;
+}
+
+std::span<const uint32_t> Bingo_Call_Table::calls(int number) const{
+	if (number < 0 || static_cast<size_t>(number) + 1 >= offsets.size())
+		return {};
+	return std::span<const uint32_t>(turns.data() + offsets[number], offsets[number + 1] - offsets[number]);
+}
+
+// Build the call table with a counting pass and a filling pass over the sequence.
+Bingo_Call_Table build_bingo_call_table(std::span<const int> bingo_sequence){
+	int max_number {-1};
+	for (int number : bingo_sequence)
+		max_number = std::max(max_number, number);
+
+	Bingo_Call_Table table;
+	table.offsets.assign(static_cast<size_t>(max_number) + 2, 0);
+	for (int number : bingo_sequence)
+		if (number >= 0)
+			++table.offsets[number + 1];
+	for (size_t n = 1; n < table.offsets.size(); ++n)
+		table.offsets[n] += table.offsets[n - 1];
+
+	table.turns.resize(table.offsets.back());
+	std::vector<uint32_t> next(table.offsets.begin(), table.offsets.end() - 1);
+	for (size_t turn = 0; turn < bingo_sequence.size(); ++turn)
+		if (bingo_sequence[turn] >= 0)
+			table.turns[next[bingo_sequence[turn]]++] = static_cast<uint32_t>(turn);
+	return table;
+}
+
+// Turn on which every cell of a board gets marked (NEVER_WINS if never). mark_number marks one
+// occurrence per call, so the k-th copy of a number on the board is marked by its k-th call.
+static std::array<uint32_t, BOARDSIZE * BOARDSIZE> calculate_mark_turns(const Bingo_Board& board, const Bingo_Call_Table& call_table){
+	std::array<uint32_t, BOARDSIZE * BOARDSIZE> mark_turns;
+	for (int cell = 0; cell < BOARDSIZE * BOARDSIZE; ++cell){
+		int number = board.contents[cell / BOARDSIZE][cell % BOARDSIZE];
+		size_t earlier_copies {0};
+		for (int previous = 0; previous < cell; ++previous)
+			earlier_copies += (board.contents[previous / BOARDSIZE][previous % BOARDSIZE] == number);
+		std::span<const uint32_t> calls = call_table.calls(number);
+		mark_turns[cell] = (earlier_copies < calls.size()) ? calls[earlier_copies] : NEVER_WINS;
+	}
+	return mark_turns;
+}
+
+static uint32_t win_turn_from_mark_turns(const std::array<uint32_t, BOARDSIZE * BOARDSIZE>& mark_turns){
+	uint32_t win_turn = NEVER_WINS;
+	for (int i = 0; i < BOARDSIZE; ++i){
+		uint32_t row_complete {0}, column_complete {0};
+		for (int j = 0; j < BOARDSIZE; ++j){
+			row_complete = std::max(row_complete, mark_turns[i * BOARDSIZE + j]);
+			column_complete = std::max(column_complete, mark_turns[j * BOARDSIZE + i]);
+		}
+		win_turn = std::min({win_turn, row_complete, column_complete});
+	}
+	return win_turn;
+}
+
+uint32_t calculate_bingo_win_turn(const Bingo_Board& board, const Bingo_Call_Table& call_table){
+	return win_turn_from_mark_turns(calculate_mark_turns(board, call_table));
+}
+
+// Best candidates of a group of boards. 'order' is the position of the board in the input and breaks
+// ties on the same turn: the earlier board is the first winner, the later board the last winner.
+struct Bingo_Winner{ uint32_t turn {NEVER_WINS}; uint64_t order {0}; int score {0}; };
+struct Bingo_Winners{ Bingo_Winner first; Bingo_Winner last; };
+
+// Winners among 'boards', the board at index i has the order 'first_order + i'.
+static Bingo_Winners find_bingo_winners(std::span<const int> bingo_sequence, const Bingo_Call_Table& call_table,
+		std::span<const Bingo_Board> boards, uint64_t first_order){
+	Bingo_Winners winners;
+	for (size_t b = 0; b < boards.size(); ++b){
+		auto mark_turns = calculate_mark_turns(boards[b], call_table);
+		uint32_t win_turn = win_turn_from_mark_turns(mark_turns);
+		if (win_turn == NEVER_WINS)
+			continue;
+		bool is_first = (winners.first.turn == NEVER_WINS || win_turn < winners.first.turn);
+		bool is_last = (winners.last.turn == NEVER_WINS || win_turn >= winners.last.turn);
+		if (!is_first && !is_last)
+			continue;
+		// Score: sum of the numbers still unmarked after the winning call times that call.
+		int unmarked_sum {0};
+		for (int cell = 0; cell < BOARDSIZE * BOARDSIZE; ++cell)
+			if (mark_turns[cell] > win_turn)
+				unmarked_sum += boards[b].contents[cell / BOARDSIZE][cell % BOARDSIZE];
+		Bingo_Winner winner {win_turn, first_order + b, unmarked_sum * bingo_sequence[win_turn]};
+		if (is_first)
+			winners.first = winner;
+		if (is_last)
+			winners.last = winner;
+	}
+	return winners;
+}
+
+// Merge the winners of two groups of boards, in any order of the groups.
+static Bingo_Winners merge_bingo_winners(const Bingo_Winners& a, const Bingo_Winners& b){
+	Bingo_Winners merged {a};
+	if (b.first.turn != NEVER_WINS && (merged.first.turn == NEVER_WINS || b.first.turn < merged.first.turn
+			|| (b.first.turn == merged.first.turn && b.first.order < merged.first.order)))
+		merged.first = b.first;
+	if (b.last.turn != NEVER_WINS && (merged.last.turn == NEVER_WINS || b.last.turn > merged.last.turn
+			|| (b.last.turn == merged.last.turn && b.last.order > merged.last.order)))
+		merged.last = b.last;
+	return merged;
+}
+
+static Bingo_Results bingo_results(const Bingo_Winners& winners){
+	// In case there is no winning board (which should not happen in a valid input), throw a runtime error.
+	if (winners.first.turn == NEVER_WINS)
+		throw std::runtime_error("No winning board found in the provided sequence.");
+	return Bingo_Results{winners.first.score, winners.last.score};
+}
+
+// Function to calculate both bingo scores from the win turns of all boards.
+Bingo_Results calculate_bingo_scores_parallel(std::span<const int> bingo_sequence, std::span<const Bingo_Board> boards, unsigned thread_count){
+	const Bingo_Call_Table call_table {build_bingo_call_table(bingo_sequence)};
+
+	// Boards are evaluated in contiguous ranges, one per thread.
+	constexpr size_t MIN_BOARDS_PER_THREAD = 4096;
+	if (thread_count == 0)
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	size_t range_count = std::max<size_t>(1, std::min<size_t>(thread_count, boards.size() / MIN_BOARDS_PER_THREAD));
+	size_t range_size = (boards.size() + range_count - 1) / range_count;
+	auto evaluate_range = [&](size_t begin, size_t end){
+		return find_bingo_winners(bingo_sequence, call_table, boards.subspan(begin, end - begin), begin);
+	};
+
+	std::vector<std::future<Bingo_Winners>> pending;
+	for (size_t r = 1; r < range_count; ++r)
+		pending.push_back(std::async(std::launch::async, evaluate_range,
+			std::min(boards.size(), r * range_size), std::min(boards.size(), (r + 1) * range_size)));
+	Bingo_Winners overall = evaluate_range(0, std::min(boards.size(), range_size));
+	for (auto& future : pending)
+		overall = merge_bingo_winners(overall, future.get());
+	return bingo_results(overall);
+}
+
+// Function to calculate both bingo scores while the input is still being read.
+// The file is cut into blocks at blank lines, so every block holds whole boards. Block 0 starts with
+// the call sequence, which every other block needs before its boards can be evaluated; blocks that are
+// parsed before it are held back. Boards are ordered by (block, position in block) for the ties.
+Bingo_Results calculate_bingo_scores_pipelined(const std::string& filename, unsigned thread_count){
+	struct Board_Batch{
+		size_t block {0};
+		std::vector<int> bingo_sequence;
+		std::vector<Bingo_Board> boards;
+	};
+	auto parse = [](Text_Block&& block){
+		Board_Batch batch {block.index, {}, {}};
+		std::string_view text {block.text};
+		if (block.index == 0){
+			// The call sequence is the first line of the file.
+			size_t newline = text.find('\n');
+			std::istringstream sequence_stream {std::string(text.substr(0, newline))};
+			batch.bingo_sequence = load_bingo_sequence(sequence_stream);
+			text = (newline == std::string_view::npos) ? std::string_view{} : text.substr(newline + 1);
+		}
+		// Same rules as load_bingo_boards: 25 numbers per board, an incomplete board is dropped.
+		std::vector<int> numbers {parse_integers<int>(text)};
+		batch.boards.resize(numbers.size() / (BOARDSIZE * BOARDSIZE));
+		for (size_t i = 0; i < batch.boards.size() * BOARDSIZE * BOARDSIZE; ++i)
+			batch.boards[i / (BOARDSIZE * BOARDSIZE)].contents[i / BOARDSIZE % BOARDSIZE][i % BOARDSIZE] = numbers[i];
+		return batch;
+	};
+
+	std::vector<int> bingo_sequence;
+	Bingo_Call_Table call_table;
+	bool have_sequence {false};
+	std::vector<Board_Batch> waiting;
+	Bingo_Winners overall;
+	auto evaluate = [&](const Board_Batch& batch){
+		overall = merge_bingo_winners(overall, find_bingo_winners(bingo_sequence, call_table, batch.boards, uint64_t{batch.block} << 32));
+	};
+	auto consume = [&](Board_Batch&& batch){
+		if (batch.block == 0){
+			bingo_sequence = std::move(batch.bingo_sequence);
+			call_table = build_bingo_call_table(bingo_sequence);
+			have_sequence = true;
+			evaluate(batch);
+			for (const Board_Batch& held : waiting)
+				evaluate(held);
+			waiting.clear();
+		}
+		else if (have_sequence)
+			evaluate(batch);
+		else
+			waiting.push_back(std::move(batch));
+	};
+
+	Load_Pipeline_Options options;
+	options.separator = "\n\n";
+	options.parser_count = (thread_count == 0) ? 0 : std::max(1u, thread_count - std::min(2u, thread_count));
+	run_load_pipeline<Board_Batch>(filename, options, parse, consume);
+	return bingo_results(overall);
+}
+
+// Function to convert the boards into the structure-of-arrays layout.
+Bingo_Board_Set build_bingo_board_set(const std::vector<Bingo_Board>& boards){
+	Bingo_Board_Set set;
+	set.count = boards.size();
+	set.values.resize(BOARDSIZE * BOARDSIZE * boards.size());
+	set.marked.resize(boards.size());
+	for (size_t b = 0; b < boards.size(); ++b){
+		for (int cell = 0; cell < BOARDSIZE * BOARDSIZE; ++cell){
+			int number = boards[b].contents[cell / BOARDSIZE][cell % BOARDSIZE];
+			// Throw an exception for numbers the 16-bit cells cannot hold.
+			if (number < 0 || number > UINT16_MAX)
+				throw std::out_of_range("Error: bingo number does not fit in 16 bits: " + std::to_string(number));
+			set.values[cell * set.count + b] = static_cast<uint16_t>(number);
+		}
+		set.marked[b] = boards[b].marked;
+	}
+	return set;
+}
+
+// Marks the called number on every board. The loops run over whole cell columns, so the compiler
+// can compare many boards per instruction. Only the first unmarked occurrence per board is marked,
+// like Bingo_Board::mark_number: the lowest set bit of the match mask is the first cell in row-major order.
+void Bingo_Board_Set::mark_number(int called_number){
+	if (called_number < 0 || called_number > UINT16_MAX)
+		return;
+	const uint16_t number = static_cast<uint16_t>(called_number);
+	// Boards are processed in blocks so the match masks stay in a small stack buffer.
+	constexpr size_t BLOCKSIZE = 256;
+	for (size_t block = 0; block < count; block += BLOCKSIZE){
+		const size_t block_size = std::min(BLOCKSIZE, count - block);
+		uint32_t matches[BLOCKSIZE] = {0};
+		for (int cell = 0; cell < BOARDSIZE * BOARDSIZE; ++cell){
+			const uint16_t* cell_values = values.data() + cell * count + block;
+			const uint32_t cell_bit = uint32_t{1} << cell;
+			for (size_t b = 0; b < block_size; ++b)
+				matches[b] |= (cell_values[b] == number) ? cell_bit : 0;
+		}
+		for (size_t b = 0; b < block_size; ++b){
+			uint32_t unmarked_matches = matches[b] & ~marked[block + b];
+			marked[block + b] |= unmarked_matches & (0u - unmarked_matches);
+		}
+	}
+}
+
+bool Bingo_Board_Set::any_line_marked(size_t board) const{
+	uint32_t complete {0};
+	for (uint32_t line_mask : BINGO_LINE_MASKS)
+		complete |= ((marked[board] & line_mask) == line_mask);
+	return complete != 0;
+}
+
+int Bingo_Board_Set::calculate_score(size_t board, int called_number) const{
+	int unmarked_sum {0};
+	for (int cell = 0; cell < BOARDSIZE * BOARDSIZE; ++cell)
+		if (!((marked[board] >> cell) & 1))
+			unmarked_sum += values[cell * count + board];
+	return unmarked_sum * called_number;
+}
+
+// Function to play the whole sequence on the board set and return both scores.
+// Winners are taken per turn, the earliest board for the first winner and the latest one for the
+// last winner, which gives the same results as the per board functions.
+Bingo_Results calculate_bingo_scores_soa(const std::vector<int>& bingo_sequence, Bingo_Board_Set& boards){
+	std::vector<uint8_t> won(boards.count, 0);
+	size_t boards_left {boards.count};
+	bool first_found {false};
+	Bingo_Results results;
+	for (int called_number : bingo_sequence){
+		if (boards_left == 0)
+			break;
+		boards.mark_number(called_number);
+		for (size_t b = 0; b < boards.count; ++b){
+			if (won[b] || !boards.any_line_marked(b))
+				continue;
+			won[b] = 1;
+			--boards_left;
+			int score = boards.calculate_score(b, called_number);
+			if (!first_found){
+				results.first_winner_score = score;
+				first_found = true;
+			}
+			results.last_winner_score = score;
+		}
+	}
+	if (!first_found)
+		throw std::runtime_error("No winning board found in the provided sequence.");
+	return results;
+}
+
 // Day 05
 
 // Constructor for Vent_Line structure to initialize line properties based on start and end points and
@@ -343,82 +1080,205 @@ Vent_Line::Vent_Line(const std::pair< int, int>& first_point, const std::pair< i
 	} 
 };
 
+// Method returning the end of the drawn path. Straight lines end at end_point; diagonals take one
+// step in y per step in x, which is end_point as well for the 45 degree lines of valid inputs.
+std::pair<int, int> Vent_Line::last_drawn_point() const{
+	if (diagonal_down)
+		return {end_point.first, start_point.second + (end_point.first - start_point.first)};
+	if (diagonal_up)
+		return {end_point.first, start_point.second - (end_point.first - start_point.first)};
+	return end_point;
+}
+
 // Method to draw the vent line on the provided diagram by incrementing the appropriate cells.
-void Vent_Line::draw_line_on_diagram(std::array<std::array<int, ARRSIZE>, ARRSIZE>& diagram) const{
+// Every kind of line is a walk through the row-major cells with a fixed stride, so one loop draws
+// them all. The bounds are checked once per line, in release builds too.
+void Vent_Line::draw_line_on_diagram(Vent_Diagram& diagram) const{
+	if (!diagram.contains(start_point) || !diagram.contains(last_drawn_point()))
+		throw std::out_of_range("Error: vent line outside of the diagram");
+
+	const std::ptrdiff_t width = diagram.width;
+	std::ptrdiff_t stride {0};
+	std::ptrdiff_t length {0};
 	if (vertical == true){
-		for (int y = start_point.second ; y <= end_point.second ; y++) {
-			// Assert bounds for vertical line
- 			assert(y >= 0 && y < ARRSIZE);
-			assert(start_point.first >= 0 && start_point.first < ARRSIZE);
-			// Vertical line | : increment cells in the same column (start_point.first) for all rows from start to end.
-			diagram[start_point.first][y] += 1;
-		}
+		// Vertical line | : same column, one row further per step.
+		stride = width;
+		length = end_point.second - start_point.second;
 	} else if (horizontal == true){
-		for (int x = start_point.first ; x <= end_point.first ; x++) {
-			// Assert bounds for horizontal line
- 			assert(x >= 0 && x < ARRSIZE);
- 			assert(start_point.second >= 0 && start_point.second < ARRSIZE);
-			// Horizontal line - : increment cells in the same row (start_point.second) for all columns from start to end.
-			diagram[x][start_point.second] += 1;
-		}
+		// Horizontal line - : same row, neighbouring cells.
+		stride = 1;
+		length = end_point.first - start_point.first;
 	} else if (diagonal_down == true){
-		int y = start_point.second;
-		for (int x = start_point.first ; x <= end_point.first ; x++){
-			// Assert bounds for diagonal down line
-			assert(x >= 0 && x < ARRSIZE);
-			assert(y >= 0 && y < ARRSIZE);
-			// Diagonal down line \ : increment cells diagonally from start to end increasing y.
-			diagram[x][y] += 1;
-			++y;
-		}
+		// Diagonal down line \ : one column right and one row down per step.
+		stride = width + 1;
+		length = end_point.first - start_point.first;
 	} else if (diagonal_up == true){
-		int y = start_point.second;
-		for (int x = start_point.first ; x <= end_point.first ; x++){
-			// Assert bounds for diagonal up line
-			assert(x >= 0 && x < ARRSIZE);
-			assert(y >= 0 && y < ARRSIZE);
-			// Diagonal up line / : increment cells diagonally from start to end decreasing y.
-			diagram[x][y] += 1;
-			--y;
-		}
+		// Diagonal up line / : one column right and one row up per step.
+		stride = 1 - width;
+		length = end_point.first - start_point.first;
+	} else {
+		return;
 	}
+
+	uint8_t* cell = diagram.cells.data() + static_cast<std::ptrdiff_t>(start_point.second - diagram.min_y) * width
+		+ (start_point.first - diagram.min_x);
+	long long new_overlaps {0};
+	for (std::ptrdiff_t step = 0; step <= length; ++step, cell += stride){
+		// Saturating increment, a cell never needs to count past 2. Reaching 2 is a new overlap.
+		new_overlaps += (*cell == 1);
+		*cell += (*cell < 2);
+	}
+	diagram.overlaps += new_overlaps;
+}
+
+// Parse the next coordinate of a vent line, skipping the separators in front of it. Like the former
+// stream based parsing, commas and the arrow characters '-' and '>' count as whitespace, so a minus
+// sign never makes a coordinate negative. Returns false if no number follows.
+static bool parse_vent_coordinate(const char*& current, const char* end, int& value) {
+	auto is_separator = [](char c){ return c == ',' || c == '-' || c == '>' || c == ' ' || (c >= '\t' && c <= '\r'); };
+	while (current != end && is_separator(*current))
+		++current;
+	if (current != end && *current == '+')
+		++current;
+	auto [number_end, error] = std::from_chars(current, end, value);
+	if (error != std::errc())
+		return false;
+	current = number_end;
+	return true;
 }
 
 // Function to load vent lines from input data strings into a vector of Vent_Line structures.
-std::vector<Vent_Line> load_vent_lines(const std::vector<std::string>& data) {
+// The lines are parsed in place, no line is copied.
+template <typename Lines>
+static std::vector<Vent_Line> parse_vent_lines(const Lines& data) {
 	std::vector<Vent_Line> vent_lines;
-	for(const std::string& original_line : data){
-		// Replace commas with spaces and remove arrows for easier parsing with stringstream.
-		std::string line = original_line;
-		
-		std::replace(line.begin(), line.end(), ',', ' ');
- 		// Lambda predicate to identify arrow characters.
- 		auto is_arrow = [](char c){ return c == '-' || c == '>'; };
- 		line.erase(std::remove_if(line.begin(), line.end(), is_arrow), line.end());
- 		std::stringstream line_stream(line);
-		
+	vent_lines.reserve(std::size(data));
+	for (std::string_view line : data){
+		const char* current = line.data();
+		const char* const end = line.data() + line.size();
+
 		// Read the two points defining the vent line from each input line.
-		std::pair<int, int> coords;
-		line_stream >> coords.first >> coords.second;
-		if (line_stream.fail()) {
- 			throw std::runtime_error("Error: invalid vent line input (first point): " + line);
- 		}
-		std::pair<int, int> point_1(coords.first, coords.second);
-        
-		line_stream >> coords.first >> coords.second;
-		if (line_stream.fail()) {
- 			throw std::runtime_error("Error: invalid vent line input (second point): " + line);
- 		}
-		std::pair<int, int> point_2(coords.first, coords.second);
-		
+		std::pair<int, int> point_1, point_2;
+		if (!parse_vent_coordinate(current, end, point_1.first) || !parse_vent_coordinate(current, end, point_1.second))
+			throw std::runtime_error("Error: invalid vent line input (first point): " + std::string(line));
+		if (!parse_vent_coordinate(current, end, point_2.first) || !parse_vent_coordinate(current, end, point_2.second))
+			throw std::runtime_error("Error: invalid vent line input (second point): " + std::string(line));
+
 		// Create a Vent_Line object and add it to the vector.
 		vent_lines.push_back(Vent_Line(point_1, point_2));
 	}
 	return vent_lines;
 }
+std::vector<Vent_Line> load_vent_lines(const std::vector<std::string>& data) {
+	return parse_vent_lines(data);
+}
+std::vector<Vent_Line> load_vent_lines(std::span<const std::string_view> data) {
+	return parse_vent_lines(data);
+}
+
+// Functions to reject diagrams that would not fit: the extents are computed in 64 bits by the callers, and
+// the cell count is only formed once both sides are known to be small.
+static bool vent_extents_fit(long long extent_x, long long extent_y){
+	const unsigned long long limit {MAX_VENT_DIAGRAM_CELLS};
+	return static_cast<unsigned long long>(extent_x) <= limit && static_cast<unsigned long long>(extent_y) <= limit
+		&& static_cast<unsigned long long>(extent_x) * static_cast<unsigned long long>(extent_y) <= limit;
+}
+static void check_vent_diagram_size(long long extent_x, long long extent_y){
+	if (!vent_extents_fit(extent_x, extent_y))
+		throw std::length_error("Error: vent diagram of " + std::to_string(extent_x) + " x " + std::to_string(extent_y) + " points is too large");
+}
+
+// Bounding box of all points the lines are drawn through, in 64 bits so the extents cannot overflow.
+struct Vent_Bounds{
+	long long min_x, min_y, max_x, max_y;
+};
+static Vent_Bounds vent_line_bounds(const std::vector<Vent_Line>& vent_lines){
+	Vent_Bounds bounds {vent_lines.front().start_point.first, vent_lines.front().start_point.second,
+		vent_lines.front().start_point.first, vent_lines.front().start_point.second};
+	for (const Vent_Line& line : vent_lines){
+		for (const auto& point : {line.start_point, line.last_drawn_point()}){
+			bounds.min_x = std::min<long long>(bounds.min_x, point.first);
+			bounds.max_x = std::max<long long>(bounds.max_x, point.first);
+			bounds.min_y = std::min<long long>(bounds.min_y, point.second);
+			bounds.max_y = std::max<long long>(bounds.max_y, point.second);
+		}
+	}
+	return bounds;
+}
+
+bool vent_diagram_fits(const std::vector<Vent_Line>& vent_lines){
+	if (vent_lines.empty())
+		return true;
+	const Vent_Bounds bounds {vent_line_bounds(vent_lines)};
+	return vent_extents_fit(bounds.max_x - bounds.min_x + 1, bounds.max_y - bounds.min_y + 1);
+}
+
+// Constructor sizing the diagram to the bounding box of all points the lines are drawn through.
+Vent_Diagram::Vent_Diagram(const std::vector<Vent_Line>& vent_lines){
+	if (vent_lines.empty())
+		return;
+	const Vent_Bounds bounds {vent_line_bounds(vent_lines)};
+	check_vent_diagram_size(bounds.max_x - bounds.min_x + 1, bounds.max_y - bounds.min_y + 1);
+	min_x = static_cast<int>(bounds.min_x);
+	min_y = static_cast<int>(bounds.min_y);
+	width = static_cast<int>(bounds.max_x - bounds.min_x + 1);
+	height = static_cast<int>(bounds.max_y - bounds.min_y + 1);
+	cells.assign(static_cast<size_t>(width) * static_cast<size_t>(height), 0);
+}
+
+// Method to grow the diagram so it covers both points. Every side that has to move is extended by at
+// least half of the current size, so a stream of lines reallocates only a logarithmic number of times.
+void Vent_Diagram::grow_to_include(const std::pair<int, int>& first_point, const std::pair<int, int>& second_point){
+	if (contains(first_point) && contains(second_point))
+		return;
+	long long low_x = std::min(first_point.first, second_point.first), high_x = std::max(first_point.first, second_point.first);
+	long long low_y = std::min(first_point.second, second_point.second), high_y = std::max(first_point.second, second_point.second);
+	if (!cells.empty()){
+		const long long old_high_x = static_cast<long long>(min_x) + width - 1, old_high_y = static_cast<long long>(min_y) + height - 1;
+		const long long slack_x = std::max(1, width / 2), slack_y = std::max(1, height / 2);
+		// Stay inside the int coordinate range the lines can use.
+		const long long grown_low_x = std::max<long long>((low_x < min_x) ? std::min(low_x, min_x - slack_x) : min_x, INT_MIN);
+		const long long grown_high_x = std::min<long long>((high_x > old_high_x) ? std::max(high_x, old_high_x + slack_x) : old_high_x, INT_MAX);
+		const long long grown_low_y = std::max<long long>((low_y < min_y) ? std::min(low_y, min_y - slack_y) : min_y, INT_MIN);
+		const long long grown_high_y = std::min<long long>((high_y > old_high_y) ? std::max(high_y, old_high_y + slack_y) : old_high_y, INT_MAX);
+		if (vent_extents_fit(grown_high_x - grown_low_x + 1, grown_high_y - grown_low_y + 1)){
+			low_x = grown_low_x;
+			high_x = grown_high_x;
+			low_y = grown_low_y;
+			high_y = grown_high_y;
+		} else {
+			// Near the size limit grow only as far as needed.
+			low_x = std::min<long long>(low_x, min_x);
+			high_x = std::max(high_x, old_high_x);
+			low_y = std::min<long long>(low_y, min_y);
+			high_y = std::max(high_y, old_high_y);
+		}
+	}
+	check_vent_diagram_size(high_x - low_x + 1, high_y - low_y + 1);
+
+	Vent_Diagram grown;
+	grown.min_x = static_cast<int>(low_x);
+	grown.min_y = static_cast<int>(low_y);
+	grown.width = static_cast<int>(high_x - low_x + 1);
+	grown.height = static_cast<int>(high_y - low_y + 1);
+	grown.cells.assign(static_cast<size_t>(grown.width) * static_cast<size_t>(grown.height), 0);
+	grown.overlaps = overlaps;
+	// Copy the old rows into place.
+	for (int row = 0; row < height; ++row){
+		const uint8_t* source = cells.data() + static_cast<size_t>(row) * width;
+		uint8_t* target = grown.cells.data() + static_cast<size_t>(row + min_y - grown.min_y) * grown.width + (min_x - grown.min_x);
+		std::copy(source, source + width, target);
+	}
+	*this = std::move(grown);
+}
+
+void Vent_Diagram::add_line(const Vent_Line& line){
+	grow_to_include(line.start_point, line.last_drawn_point());
+	line.draw_line_on_diagram(*this);
+}
 
 // Function to draw all straight (vertical and horizontal) vent lines on the diagram (first part of the challenge).
-void draw_straight_lines(const std::vector<Vent_Line>& vent_lines, std::array<std::array<int, ARRSIZE>, ARRSIZE>& diagram) {
+void draw_straight_lines(const std::vector<Vent_Line>& vent_lines, Vent_Diagram& diagram) {
 	for (const Vent_Line& line : vent_lines) {
 		if (line.vertical || line.horizontal) {
 			line.draw_line_on_diagram(diagram);
@@ -427,7 +1287,7 @@ void draw_straight_lines(const std::vector<Vent_Line>& vent_lines, std::array<st
 }
 
 // Function to draw all diagonal vent lines on the diagram (second part of the challenge).
-void draw_diagonal_lines(const std::vector<Vent_Line>& vent_lines, std::array<std::array<int, ARRSIZE>, ARRSIZE>& diagram) {
+void draw_diagonal_lines(const std::vector<Vent_Line>& vent_lines, Vent_Diagram& diagram) {
 	for (const Vent_Line& line : vent_lines) {
 		if (line.diagonal_down || line.diagonal_up) {
 			line.draw_line_on_diagram(diagram);
@@ -436,14 +1296,333 @@ void draw_diagonal_lines(const std::vector<Vent_Line>& vent_lines, std::array<st
 }
 
 // Function to count the number of points where at least two lines overlap on the diagram, 
-// the value in the cell represents the number of lines passing through it.
-int count_overlaps(const std::array<std::array<int, ARRSIZE>, ARRSIZE>& diagram) {
+// the value in the cell is the number of lines passing through it (saturated at 2).
+int count_overlaps(const Vent_Diagram& diagram) {
 	int count {0};
-	for (const auto& row : diagram){
-		for (const auto& cell : row){
-			if (cell >= 2)
-				count += 1;
+	for (uint8_t cell : diagram.cells)
+		count += (cell >= 2);
+	return count;
+}
+
+// A vent line as a walk from its start point: point(t) = start + t * (step_x, step_y), t = 0..length.
+struct Vent_Walk{
+	int start_x, start_y;
+	int step_x, step_y;
+	int length;
+};
+static Vent_Walk make_vent_walk(const Vent_Line& line){
+	Vent_Walk walk {line.start_point.first, line.start_point.second, 1, 0, line.end_point.first - line.start_point.first};
+	if (line.vertical){
+		walk.step_x = 0;
+		walk.step_y = 1;
+		walk.length = line.end_point.second - line.start_point.second;
+	} else if (line.diagonal_down){
+		walk.step_y = 1;
+	} else if (line.diagonal_up){
+		walk.step_y = -1;
+	}
+	return walk;
+}
+
+// Restrict the walk to the steps inside [low, high] along one axis. Steps are -1, 0 or 1, so the
+// limits are exact integers.
+static void clip_vent_walk(int start, int step, int low, int high, int& first, int& last){
+	if (step == 0){
+		if (start < low || start > high)
+			last = first - 1;
+		return;
+	}
+	int t_low = (low - start) * step;
+	int t_high = (high - start) * step;
+	first = std::max(first, std::min(t_low, t_high));
+	last = std::min(last, std::max(t_low, t_high));
+}
+
+// Last coordinate of the tile starting at 'low' along an axis of the diagram, computed in 64 bits as a
+// diagram can end at INT_MAX.
+static int tile_high(int low, int diagram_min, int diagram_extent){
+	return static_cast<int>(std::min<long long>(static_cast<long long>(low) + TILESIZE, static_cast<long long>(diagram_min) + diagram_extent) - 1);
+}
+
+// Function shared by both tiled drawing functions.
+static long long draw_lines_tiled(const std::vector<Vent_Line>& vent_lines, Vent_Diagram& diagram, bool diagonals, unsigned thread_count){
+	const int tiles_x = (diagram.width + TILESIZE - 1) / TILESIZE;
+	const int tiles_y = (diagram.height + TILESIZE - 1) / TILESIZE;
+
+	// Bin every selected line into the tiles it crosses: walk its tile columns and add the
+	// tile rows its clipped part spans in each of them.
+	std::vector<std::vector<uint32_t>> bins(static_cast<size_t>(tiles_x) * tiles_y);
+	std::vector<Vent_Walk> walks(vent_lines.size());
+	for (size_t i = 0; i < vent_lines.size(); ++i){
+		const Vent_Line& line = vent_lines[i];
+		bool is_diagonal = line.diagonal_down || line.diagonal_up;
+		if (is_diagonal != diagonals || !(line.vertical || line.horizontal || is_diagonal))
+			continue;
+		if (!diagram.contains(line.start_point) || !diagram.contains(line.last_drawn_point()))
+			throw std::out_of_range("Error: vent line outside of the diagram");
+		const Vent_Walk walk = walks[i] = make_vent_walk(line);
+		const int last_x = walk.start_x + walk.step_x * walk.length;
+		for (int tx = (std::min(walk.start_x, last_x) - diagram.min_x) / TILESIZE; tx <= (std::max(walk.start_x, last_x) - diagram.min_x) / TILESIZE; ++tx){
+			int first {0}, last {walk.length};
+			const int tile_x = diagram.min_x + tx * TILESIZE;
+			clip_vent_walk(walk.start_x, walk.step_x, tile_x, tile_high(tile_x, diagram.min_x, diagram.width), first, last);
+			if (first > last)
+				continue;
+			const int y_first = walk.start_y + walk.step_y * first - diagram.min_y;
+			const int y_last = walk.start_y + walk.step_y * last - diagram.min_y;
+			for (int ty = std::min(y_first, y_last) / TILESIZE; ty <= std::max(y_first, y_last) / TILESIZE; ++ty)
+				bins[static_cast<size_t>(ty) * tiles_x + tx].push_back(static_cast<uint32_t>(i));
 		}
 	}
-	return count;
-}
\ No newline at end of file
+
+	// Workers take the next tile from a shared counter and draw the clipped parts of its lines,
+	// tallying the cells that reach 2 locally.
+	std::atomic<size_t> next_tile {0};
+	auto draw_tiles = [&]() -> long long {
+		long long overlaps {0};
+		const std::ptrdiff_t width = diagram.width;
+		for (size_t tile = next_tile++; tile < bins.size(); tile = next_tile++){
+			const int tx = static_cast<int>(tile % tiles_x), ty = static_cast<int>(tile / tiles_x);
+			const int low_x = diagram.min_x + tx * TILESIZE, high_x = tile_high(low_x, diagram.min_x, diagram.width);
+			const int low_y = diagram.min_y + ty * TILESIZE, high_y = tile_high(low_y, diagram.min_y, diagram.height);
+			for (uint32_t i : bins[tile]){
+				const Vent_Walk& walk = walks[i];
+				int first {0}, last {walk.length};
+				clip_vent_walk(walk.start_x, walk.step_x, low_x, high_x, first, last);
+				clip_vent_walk(walk.start_y, walk.step_y, low_y, high_y, first, last);
+				const std::ptrdiff_t stride = walk.step_y * width + walk.step_x;
+				uint8_t* cell = diagram.cells.data() + (walk.start_y + walk.step_y * first - diagram.min_y) * width
+					+ (walk.start_x + walk.step_x * first - diagram.min_x);
+				for (int t = first; t <= last; ++t, cell += stride){
+					overlaps += (*cell == 1);
+					*cell += (*cell < 2);
+				}
+			}
+		}
+		return overlaps;
+	};
+
+	if (thread_count == 0)
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	thread_count = static_cast<unsigned>(std::min<size_t>(thread_count, bins.size()));
+	std::vector<std::future<long long>> workers;
+	for (unsigned t = 1; t < thread_count; ++t)
+		workers.push_back(std::async(std::launch::async, draw_tiles));
+	long long new_overlaps = draw_tiles();
+	for (auto& worker : workers)
+		new_overlaps += worker.get();
+	diagram.overlaps += new_overlaps;
+	return diagram.overlaps;
+}
+
+long long draw_straight_lines_tiled(const std::vector<Vent_Line>& vent_lines, Vent_Diagram& diagram, unsigned thread_count){
+	return draw_lines_tiled(vent_lines, diagram, false, thread_count);
+}
+
+long long draw_diagonal_lines_tiled(const std::vector<Vent_Line>& vent_lines, Vent_Diagram& diagram, unsigned thread_count){
+	return draw_lines_tiled(vent_lines, diagram, true, thread_count);
+}
+
+// Function to count both overlap answers with reading and parsing overlapped. The parsed batches are
+// gathered in completion order, which does not change the counts. Drawing waits for the last batch:
+// the diagram needs the bounding box of all lines, and tiled drawing into it is much faster than
+// drawing every line as it arrives into a diagram that keeps growing.
+Vent_Overlaps calculate_vent_overlaps_pipelined(const std::string& filename, unsigned thread_count){
+	auto parse = [](Text_Block&& block){
+		return load_vent_lines(split_lines(block.text));
+	};
+	std::vector<Vent_Line> vent_lines;
+	auto consume = [&](std::vector<Vent_Line>&& batch){
+		if (vent_lines.empty())
+			vent_lines = std::move(batch);
+		else
+			vent_lines.insert(vent_lines.end(), batch.begin(), batch.end());
+	};
+
+	Load_Pipeline_Options options;
+	options.parser_count = (thread_count == 0) ? 0 : std::max(1u, thread_count - std::min(2u, thread_count));
+	run_load_pipeline<std::vector<Vent_Line>>(filename, options, parse, consume);
+
+	Vent_Overlaps overlaps;
+	overlaps.line_count = vent_lines.size();
+	if (!vent_diagram_fits(vent_lines)){
+		overlaps.straight = count_overlaps_analytic(vent_lines, false);
+		overlaps.all = count_overlaps_analytic(vent_lines, true);
+		return overlaps;
+	}
+	Vent_Diagram diagram(vent_lines);
+	overlaps.straight = draw_straight_lines_tiled(vent_lines, diagram, thread_count);
+	overlaps.all = draw_diagonal_lines_tiled(vent_lines, diagram, thread_count);
+	return overlaps;
+}
+
+// The four orientations a vent line can have. Every point is described by the key of the line it
+// lies on in an orientation and by its position along that line (param).
+enum class Vent_Orientation { vertical, horizontal, diagonal_down, diagonal_up };
+constexpr Vent_Orientation VENT_ORIENTATIONS[] {
+	Vent_Orientation::vertical, Vent_Orientation::horizontal, Vent_Orientation::diagonal_down, Vent_Orientation::diagonal_up
+};
+
+static long long vent_key(Vent_Orientation orientation, long long x, long long y){
+	switch (orientation){
+		case Vent_Orientation::vertical:      return x;
+		case Vent_Orientation::horizontal:    return y;
+		case Vent_Orientation::diagonal_down: return x - y;
+		case Vent_Orientation::diagonal_up:   return x + y;
+	}
+	return 0;
+}
+static long long vent_param(Vent_Orientation orientation, long long x, long long y){
+	return (orientation == Vent_Orientation::vertical) ? y : x;
+}
+static std::pair<long long, long long> vent_point(Vent_Orientation orientation, long long key, long long param){
+	switch (orientation){
+		case Vent_Orientation::vertical:      return {key, param};
+		case Vent_Orientation::horizontal:    return {param, key};
+		case Vent_Orientation::diagonal_down: return {param, param - key};
+		case Vent_Orientation::diagonal_up:   return {param, key - param};
+	}
+	return {0, 0};
+}
+
+// All lines of one orientation, grouped by key. For group 'g', covered[covered_offsets[g]..covered_offsets[g+1])
+// are the disjoint param intervals covered at least once and doubled[...] those covered at least twice.
+struct Vent_Line_Groups{
+	struct Interval{ long long low; long long high; };
+	std::vector<long long> keys;
+	std::vector<size_t> covered_offsets {0};
+	std::vector<Interval> covered;
+	std::vector<size_t> doubled_offsets {0};
+	std::vector<Interval> doubled;
+
+	// Index of the group with this key, or keys.size() if there is none.
+	size_t find_group(long long key) const{
+		auto it = std::lower_bound(keys.begin(), keys.end(), key);
+		return (it != keys.end() && *it == key) ? static_cast<size_t>(it - keys.begin()) : keys.size();
+	}
+	static bool contains(const Interval* first, const Interval* last, long long param){
+		auto it = std::upper_bound(first, last, param, [](long long value, const Interval& interval){ return value < interval.low; });
+		return it != first && (it - 1)->high >= param;
+	}
+	bool covers(size_t group, long long param) const{
+		return contains(covered.data() + covered_offsets[group], covered.data() + covered_offsets[group + 1], param);
+	}
+	bool doubles(size_t group, long long param) const{
+		return contains(doubled.data() + doubled_offsets[group], doubled.data() + doubled_offsets[group + 1], param);
+	}
+};
+
+// Sort the segments of one orientation by (key, low) and sweep every group once: a segment starting
+// before the furthest end seen so far overlaps the earlier ones from its start to that end.
+static Vent_Line_Groups build_vent_line_groups(std::vector<std::pair<long long, Vent_Line_Groups::Interval>>& segments){
+	using Interval = Vent_Line_Groups::Interval;
+	std::sort(segments.begin(), segments.end(), [](const auto& a, const auto& b){
+		return a.first != b.first ? a.first < b.first : a.second.low < b.second.low;
+	});
+	auto append_merged = [](std::vector<Interval>& intervals, size_t group_start, Interval interval){
+		if (intervals.size() > group_start && interval.low <= intervals.back().high + 1)
+			intervals.back().high = std::max(intervals.back().high, interval.high);
+		else
+			intervals.push_back(interval);
+	};
+
+	Vent_Line_Groups groups;
+	size_t i {0};
+	while (i < segments.size()){
+		const long long key = segments[i].first;
+		long long furthest_end = segments[i].second.low - 1;
+		for (; i < segments.size() && segments[i].first == key; ++i){
+			const Interval& interval = segments[i].second;
+			if (interval.low <= furthest_end)
+				append_merged(groups.doubled, groups.doubled_offsets.back(), {interval.low, std::min(interval.high, furthest_end)});
+			append_merged(groups.covered, groups.covered_offsets.back(), interval);
+			furthest_end = std::max(furthest_end, interval.high);
+		}
+		groups.keys.push_back(key);
+		groups.covered_offsets.push_back(groups.covered.size());
+		groups.doubled_offsets.push_back(groups.doubled.size());
+	}
+	return groups;
+}
+
+// Function to count overlap points analytically (see utils.hpp).
+long long count_overlaps_analytic(const std::vector<Vent_Line>& vent_lines, bool include_diagonals){
+	using Interval = Vent_Line_Groups::Interval;
+	const size_t orientation_count = include_diagonals ? 4 : 2;
+
+	// Sort every line into its orientation as (key, param interval).
+	std::vector<std::pair<long long, Interval>> segments[4];
+	for (const Vent_Line& line : vent_lines){
+		Vent_Orientation orientation;
+		if (line.vertical) orientation = Vent_Orientation::vertical;
+		else if (line.horizontal) orientation = Vent_Orientation::horizontal;
+		else if (line.diagonal_down) orientation = Vent_Orientation::diagonal_down;
+		else orientation = Vent_Orientation::diagonal_up;
+		size_t o = static_cast<size_t>(orientation);
+		if (o >= orientation_count)
+			continue;
+		const std::pair<int, int> last = line.last_drawn_point();
+		long long first_param = vent_param(orientation, line.start_point.first, line.start_point.second);
+		long long last_param = vent_param(orientation, last.first, last.second);
+		segments[o].push_back({vent_key(orientation, line.start_point.first, line.start_point.second),
+			Interval{std::min(first_param, last_param), std::max(first_param, last_param)}});
+	}
+	Vent_Line_Groups groups[4];
+	for (size_t o = 0; o < orientation_count; ++o)
+		groups[o] = build_vent_line_groups(segments[o]);
+
+	// Points covered twice by collinear lines. Groups of one orientation never share a point, but a
+	// point can be doubled in two orientations at once; those are fixed up with the crossings below.
+	long long overlaps {0};
+	for (size_t o = 0; o < orientation_count; ++o)
+		for (const Interval& interval : groups[o].doubled)
+			overlaps += interval.high - interval.low + 1;
+
+	// Every point where lines of two orientations cross, collected once in a hash set.
+	std::unordered_set<uint64_t> crossings;
+	for (size_t first = 0; first < orientation_count; ++first){
+		for (size_t second = first + 1; second < orientation_count; ++second){
+			const Vent_Orientation first_orientation = VENT_ORIENTATIONS[first];
+			const Vent_Orientation second_orientation = VENT_ORIENTATIONS[second];
+			const Vent_Line_Groups& other = groups[second];
+			for (size_t g = 0; g < groups[first].keys.size(); ++g){
+				const long long key = groups[first].keys[g];
+				// Along a line of the first orientation the key of the second one changes linearly:
+				// other_key(param) = slope * param + base.
+				auto [x0, y0] = vent_point(first_orientation, key, 0);
+				auto [x1, y1] = vent_point(first_orientation, key, 1);
+				const long long base = vent_key(second_orientation, x0, y0);
+				const long long slope = vent_key(second_orientation, x1, y1) - base;
+				for (size_t c = groups[first].covered_offsets[g]; c < groups[first].covered_offsets[g + 1]; ++c){
+					const Interval& interval = groups[first].covered[c];
+					long long low_key = slope * (slope > 0 ? interval.low : interval.high) + base;
+					long long high_key = slope * (slope > 0 ? interval.high : interval.low) + base;
+					auto it = std::lower_bound(other.keys.begin(), other.keys.end(), low_key);
+					for (; it != other.keys.end() && *it <= high_key; ++it){
+						// Skip keys the line only crosses between two integer points (x - y and x + y parities).
+						if ((*it - base) % slope != 0)
+							continue;
+						auto [x, y] = vent_point(first_orientation, key, (*it - base) / slope);
+						if (other.covers(static_cast<size_t>(it - other.keys.begin()), vent_param(second_orientation, x, y)))
+							crossings.insert((static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y));
+					}
+				}
+			}
+		}
+	}
+
+	// A crossing doubled in no orientation is a new overlap point; one doubled in several
+	// orientations was counted once per orientation above.
+	for (uint64_t crossing : crossings){
+		const long long x = static_cast<int32_t>(crossing >> 32);
+		const long long y = static_cast<int32_t>(crossing & 0xFFFFFFFFu);
+		long long doubled_in {0};
+		for (size_t o = 0; o < orientation_count; ++o){
+			size_t group = groups[o].find_group(vent_key(VENT_ORIENTATIONS[o], x, y));
+			if (group != groups[o].keys.size() && groups[o].doubles(group, vent_param(VENT_ORIENTATIONS[o], x, y)))
+				++doubled_in;
+		}
+		overlaps += (doubled_in == 0) ? 1 : 1 - doubled_in;
+	}
+	return overlaps;
+}
@@ -4,70 +4,303 @@
 #include <fstream>
 #include <stdexcept>
 #include <array>
+#include <type_traits>
+#include <span>
+#include <functional>
+#include <string_view>
+#include <cstdint>
+#include <climits>
+#include "input.hpp"
 
 // Function to load data from a file into a vector.
+// Integer types go through the memory-mapped loader and std::from_chars, any other type
+// is still read with the stream extraction operator.
 template <typename T>
 std::vector<T> load_input(const std::string& filename) {
-	std::ifstream input_file_stream(filename);
-    // Throw an exception if the file cannot be opened.
-    if (!input_file_stream)
-		  throw std::runtime_error("Failed to open input file: " + filename);
-
-    std::vector<T> input_vector;
-	for (T n; input_file_stream >> n; )
-      input_vector.push_back(n);
-	
-    return input_vector;
+	if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+		// Input_File throws an exception if the file cannot be opened.
+		Input_File input_file(filename);
+		return parse_integers<T>(input_file.contents());
+	} else {
+		std::ifstream input_file_stream(filename);
+		// Throw an exception if the file cannot be opened.
+		if (!input_file_stream)
+			throw std::runtime_error("Failed to open input file: " + filename);
+
+		std::vector<T> input_vector;
+		for (T n; input_file_stream >> n; )
+			input_vector.push_back(n);
+
+		return input_vector;
+	}
 }
-// Specialization for string: read file line by line.
+// Specialization for string: split the memory-mapped file into lines (std::getline semantics).
 template <>
 inline std::vector<std::string> load_input<std::string>(const std::string& filename) {
-    std::ifstream input_file_stream(filename);
-    // Throw an exception if the file cannot be opened.
-    if (!input_file_stream)
-        throw std::runtime_error("Failed to open input file: " + filename);
+	// Input_File throws an exception if the file cannot be opened.
+	Input_File input_file(filename);
+	std::vector<std::string> lines;
+	lines.reserve(count_lines(input_file.contents()));
+	for (std::string_view line : split_lines(input_file.contents()))
+		lines.emplace_back(line);
 
-    std::vector<std::string> lines;
-    std::string line;
-    while (std::getline(input_file_stream, line))
-        lines.push_back(line);
-
-    return lines;
+	return lines;
 }
 
 // Day 01 specific utility functions.
 int count_increases_simple(const std::vector<int>& data);
 int count_increases_sliding_window(const std::vector<int>& data);
 
+// Sliding windows of any width: the sum of 'window' consecutive measurements grows exactly when the
+// measurement entering the window is larger than the one leaving it, so this counts the indices with
+// data[i] < data[i + window] (window 1 is the simple count, 3 the puzzle's sliding window).
+// The series is cut into one chunk per thread (0 = one per hardware thread); neighbouring chunks
+// overlap by 'window' measurements so no comparison across a boundary is lost.
+// Throws std::runtime_error for a window of 0.
+unsigned long long count_window_increases(std::span<const int> data, size_t window, unsigned thread_count = 0);
+// The same count for every width in 'windows' in a single pass over memory: each thread walks its
+// chunk in cache sized blocks and compares every block at all widths before moving on.
+// The counts are returned in the order of 'windows'.
+std::vector<unsigned long long> count_window_increases(std::span<const int> data, std::span<const size_t> windows, unsigned thread_count = 0);
+
+// Streaming counterpart of the two functions above for feeds that do not fit in memory.
+// Only the last three measurements are carried between calls, so memory use is constant
+// and both answers can be read at any point of the feed.
+struct Depth_Increase_Counter{
+	int last_values[3] {0};
+	unsigned long long measurements_seen {0};
+	unsigned long long simple_count {0};
+	unsigned long long sliding_window_count {0};
+
+	void push(int measurement){
+		// Same comparisons as the vector based functions: data[i-1] < data[i] and data[i-3] < data[i].
+		if (measurements_seen >= 1 && last_values[2] < measurement)
+			++simple_count;
+		if (measurements_seen >= 3 && last_values[0] < measurement)
+			++sliding_window_count;
+		last_values[0] = last_values[1];
+		last_values[1] = last_values[2];
+		last_values[2] = measurement;
+		++measurements_seen;
+	}
+	void push(std::span<const int> measurements){
+		for (int measurement : measurements)
+			push(measurement);
+	}
+};
+// Read whitespace separated measurements from a file descriptor (0 for stdin) in fixed size chunks
+// and feed them to the counter. 'on_chunk' is called after every chunk to report progress.
+void stream_depth_measurements(int fd, Depth_Increase_Counter& counter,
+		const std::function<void(const Depth_Increase_Counter&)>& on_chunk = {});
+
 // Day 02 specific utility functions.
-int calculate_final_position(const std::vector<std::string>& data);
-int calculate_final_position_with_aim(const std::vector<std::string>& data);
+enum class Submarine_Direction { forward, down, up };
+struct Submarine_Command{
+	Submarine_Direction direction {Submarine_Direction::forward};
+	int value {0};
+};
+// Parse one line of the command log without allocating, throws std::runtime_error for invalid lines.
+Submarine_Command parse_submarine_command(std::string_view line);
+// The solvers below take either owned strings or the line views of a Line_Buffer. The products are
+// computed in 64 bits, large logs overflow int.
+long long calculate_final_position(const std::vector<std::string>& data);
+long long calculate_final_position(std::span<const std::string_view> data);
+long long calculate_final_position_with_aim(const std::vector<std::string>& data);
+long long calculate_final_position_with_aim(std::span<const std::string_view> data);
+
+// Summary of a contiguous slice of commands that can be combined with its neighbours in any grouping.
+// Entering the slice with aim 'a' moves the submarine forward by 'forward', changes the aim by
+// 'aim_change' and adds 'depth_at_zero_aim + a * forward' to the depth.
+struct Course_Segment{
+	long long forward {0};
+	long long aim_change {0};
+	long long depth_at_zero_aim {0};
+};
+// Summary of 'first' followed directly by 'second'.
+Course_Segment combine_course_segments(const Course_Segment& first, const Course_Segment& second);
+// Both answers of the puzzle, taken from one combined summary.
+struct Course_Result{
+	long long final_position {0};
+	long long final_position_with_aim {0};
+};
+// Split the raw command log at line boundaries, summarize the chunks on 'thread_count' threads
+// (0 = one per hardware thread) and merge the summaries pairwise. Throws on invalid lines like
+// the functions above.
+Course_Result calculate_final_positions_parallel(std::string_view commands, unsigned thread_count = 0);
+// Both answers from already parsed commands (e.g. mapped from the input cache).
+Course_Result calculate_final_positions(std::span<const Submarine_Command> commands);
 
 // Day 03 specific utility functions.
 int binary_str_to_int(const std::string& str);
+
+// Diagnostic report stored bit-sliced: one bitset per bit position (column), where bit 'r' of a
+// column is the bit of row 'r'. Counting the '1's of a position is then a popcount over
+// 64-bit words instead of a scan over characters. Any row width is supported.
+struct Bit_Columns{
+	size_t width {0};
+	size_t rows {0};
+	size_t words_per_column {0};
+	// Column-major storage, column 'position' occupies words_per_column consecutive words.
+	std::vector<uint64_t> words;
+
+	const uint64_t* column(size_t position) const { return words.data() + position * words_per_column; }
+	bool bit(size_t row, size_t position) const { return (column(position)[row / 64] >> (row % 64)) & 1; }
+	size_t count_ones(size_t position) const;
+};
+// Transpose the report into columns, throws std::runtime_error if the rows differ in width.
+Bit_Columns build_bit_columns(const std::vector<std::string>& data);
+Bit_Columns build_bit_columns(std::span<const std::string_view> data);
+// Most common bit of every position as a string of '0'/'1' (the gamma rate for any width).
+std::string most_common_bits(const Bit_Columns& columns);
+
+// Report rows packed into integers (first bit = most significant) and sorted once. Rows that share
+// a prefix form one contiguous range, so every filtering step of the life support rating is a
+// binary search for the first row with a '1' at the next position.
+struct Sorted_Diagnostic_Index{
+	size_t width {0};
+	std::vector<uint64_t> values;
+};
+// Build the index from the bit columns, throws std::overflow_error for rows wider than 64 bits.
+Sorted_Diagnostic_Index build_sorted_index(const Bit_Columns& columns);
+// Oxygen generator rating with 'keep_most_common' (ties keep '1'), CO2 scrubber rating without
+// it (ties keep '0'). Costs O(width * log rows).
+unsigned long long find_rating(const Sorted_Diagnostic_Index& index, bool keep_most_common);
+unsigned long long find_rating(std::span<const uint64_t> sorted_values, size_t width, bool keep_most_common);
+// Both answers from rows that are already packed and sorted like in Sorted_Diagnostic_Index.
+unsigned long long calculate_gamma_epsilon_product(std::span<const uint64_t> sorted_values, size_t width);
+unsigned long long calculate_life_support_rating(std::span<const uint64_t> sorted_values, size_t width);
 unsigned long long calculate_gamma_epsilon_product(const std::vector<std::string>& data);
+unsigned long long calculate_gamma_epsilon_product(std::span<const std::string_view> data);
 unsigned long long calculate_life_support_rating(const std::vector<std::string>& data);
+unsigned long long calculate_life_support_rating(std::span<const std::string_view> data);
 
 // Day 04 specific utility functions.
 
 // Bingo board structure, size and related methods.
 constexpr int BOARDSIZE {5};
+// Bit 'row * BOARDSIZE + column' of a marked mask is set once that cell is marked. A line is
+// complete when all bits of one of these masks are set (five rows, then five columns).
+constexpr std::array<uint32_t, 2 * BOARDSIZE> BINGO_LINE_MASKS {
+	0x1Fu << 0, 0x1Fu << 5, 0x1Fu << 10, 0x1Fu << 15, 0x1Fu << 20,
+	0x108421u << 0, 0x108421u << 1, 0x108421u << 2, 0x108421u << 3, 0x108421u << 4
+};
 struct Bingo_Board{
 	std::array< std::array<int, BOARDSIZE>, BOARDSIZE> contents {0};
-	int horizontal_lines[BOARDSIZE] {0};
-	int vertical_lines[BOARDSIZE] {0};
+	uint32_t marked {0};
 	
+	bool is_marked(int row, int column) const { return (marked >> (row * BOARDSIZE + column)) & 1; }
 	void mark_number(int called_number);
-	bool any_line_marked();
-	int calculate_score(int called_number);
+	bool mark_cell(int row, int column);
+	bool any_line_marked() const;
+	int calculate_score(int called_number) const;
 };
+
+// Location of one board cell holding a given number.
+struct Bingo_Cell_Ref{
+	uint32_t board;
+	uint8_t row;
+	uint8_t column;
+};
+// Index from every number to the cells holding it, in board order. The occurrences of all
+// numbers are stored back to back (compressed rows), 'offsets[n]' is where those of 'n' begin.
+struct Bingo_Number_Index{
+	std::vector<uint32_t> offsets;
+	std::vector<Bingo_Cell_Ref> cells;
+
+	std::span<const Bingo_Cell_Ref> occurrences(int number) const;
+};
+Bingo_Number_Index build_bingo_index(const std::vector<Bingo_Board>& boards);
+
 std::vector<int> load_bingo_sequence(std::istream& input_file);
 std::vector<Bingo_Board> load_bingo_boards(std::istream& input_file);
+// Load the boards and build their number index in the same call.
+std::vector<Bingo_Board> load_bingo_boards(std::istream& input_file, Bingo_Number_Index& index);
 int calculate_bingo_first_winner_score(const std::vector<int>& bingo_sequence, std::vector<Bingo_Board>& boards);
 int calculate_bingo_last_winner_score(const std::vector<int>& bingo_sequence, std::vector<Bingo_Board>& boards);
+// Same results, but every call only touches the boards that contain the called number.
+int calculate_bingo_first_winner_score(const std::vector<int>& bingo_sequence, std::vector<Bingo_Board>& boards, const Bingo_Number_Index& index);
+int calculate_bingo_last_winner_score(const std::vector<int>& bingo_sequence, std::vector<Bingo_Board>& boards, const Bingo_Number_Index& index);
+
+// Turns at which every number is called, stored back to back like Bingo_Number_Index.
+// A number called k times is marked on a board for its k-th occurrence only at its k-th call.
+struct Bingo_Call_Table{
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> turns;
+
+	std::span<const uint32_t> calls(int number) const;
+};
+Bingo_Call_Table build_bingo_call_table(std::span<const int> bingo_sequence);
+// Turn a board never wins on.
+constexpr uint32_t NEVER_WINS = UINT32_MAX;
+// Turn on which the board completes its first line: the minimum over its rows and columns of
+// the latest turn any cell of that line gets marked. The board itself is not modified.
+uint32_t calculate_bingo_win_turn(const Bingo_Board& board, const Bingo_Call_Table& call_table);
+
+struct Bingo_Results{
+	int first_winner_score {0};
+	int last_winner_score {0};
+};
+// Both parts in one pass: the win turn and score of every board are computed independently on
+// 'thread_count' threads (0 = one per hardware thread). Ties on the same turn go to the earlier
+// board for the first winner and to the later board for the last winner, as with the turn by turn
+// simulation. Throws std::runtime_error if no board wins.
+Bingo_Results calculate_bingo_scores_parallel(std::span<const int> bingo_sequence, std::span<const Bingo_Board> boards, unsigned thread_count = 0);
+// Same results with loading, parsing and solving overlapped (see load_pipeline.hpp): the file is read in
+// blocks on one thread, the blocks are parsed on 'thread_count' - 2 threads (at least one, 0 = all hardware
+// threads) and the boards are evaluated batch by batch as they are parsed. Throws std::runtime_error if
+// the file cannot be read or no board wins.
+Bingo_Results calculate_bingo_scores_pipelined(const std::string& filename, unsigned thread_count = 0);
+
+// Compact structure-of-arrays storage for large board sets: 16-bit cell values stored cell by cell
+// across all boards ('values[cell * count + board]') plus one 25-bit marked mask per board,
+// 54 bytes per board. Marking and win checks run over all boards at once.
+struct Bingo_Board_Set{
+	size_t count {0};
+	std::vector<uint16_t> values;
+	std::vector<uint32_t> marked;
+
+	void mark_number(int called_number);
+	bool any_line_marked(size_t board) const;
+	int calculate_score(size_t board, int called_number) const;
+};
+// Throws std::out_of_range for numbers outside 0..65535.
+Bingo_Board_Set build_bingo_board_set(const std::vector<Bingo_Board>& boards);
+// Play the sequence on the set (the marks are kept) and return both scores.
+Bingo_Results calculate_bingo_scores_soa(const std::vector<int>& bingo_sequence, Bingo_Board_Set& boards);
 
 // Day 05 specific utility functions.
-constexpr int ARRSIZE = 1000;
+struct Vent_Line;
+
+// Largest diagram that is allocated, in cells (one byte each). Bounding boxes beyond it, or wider
+// or taller than the int coordinates can index, throw std::length_error.
+constexpr unsigned long long MAX_VENT_DIAGRAM_CELLS {1ull << 30};
+
+// Overlap diagram covering exactly the bounding box of the vent lines it is built for, stored
+// row by row on the heap. The puzzle only asks whether at least two lines cross a point, so the
+// counters are single bytes that saturate at 2. The number of cells at 2 is kept up to date while
+// drawing (a cell going from 1 to 2 adds one), so the answer can be read at any time.
+struct Vent_Diagram{
+	int min_x {0};
+	int min_y {0};
+	int width {0};
+	int height {0};
+	// cells[(y - min_y) * width + (x - min_x)]
+	std::vector<uint8_t> cells;
+	long long overlaps {0};
+
+	Vent_Diagram() = default;
+	// Throws std::length_error if the bounding box exceeds MAX_VENT_DIAGRAM_CELLS (see vent_diagram_fits).
+	explicit Vent_Diagram(const std::vector<Vent_Line>& vent_lines);
+	bool contains(const std::pair<int, int>& point) const {
+		return point.first >= min_x && static_cast<long long>(point.first) - min_x < width
+			&& point.second >= min_y && static_cast<long long>(point.second) - min_y < height;
+	}
+	uint8_t at(int x, int y) const { return cells[static_cast<size_t>(y - min_y) * width + (x - min_x)]; }
+	// Live mode: draw one more line, growing the diagram first if the line does not fit.
+	// The growth is geometric, so streaming lines in costs amortized O(line length).
+	void add_line(const Vent_Line& line);
+	void grow_to_include(const std::pair<int, int>& first_point, const std::pair<int, int>& second_point);
+};
 
 struct Vent_Line{
 	std::pair< int, int> start_point;
@@ -78,9 +311,39 @@ struct Vent_Line{
 	bool diagonal_up{false};
 	
 	Vent_Line(const std::pair< int, int>& first_point, const std::pair< int, int>& second_point);
-	void draw_line_on_diagram(std::array<std::array<int, ARRSIZE>, ARRSIZE>& diagram) const;
+	// Last point the line is drawn through: for diagonals the drawing follows x and steps y by one.
+	std::pair<int, int> last_drawn_point() const;
+	// Throws std::out_of_range if the line leaves the diagram.
+	void draw_line_on_diagram(Vent_Diagram& diagram) const;
 };
+// Parse "x1,y1 -> x2,y2" lines in place, throws std::runtime_error for malformed lines.
 std::vector<Vent_Line> load_vent_lines(const std::vector<std::string>& data);
-void draw_straight_lines(const std::vector<Vent_Line>& vent_lines, std::array<std::array<int, ARRSIZE>, ARRSIZE>& diagram);
-void draw_diagonal_lines(const std::vector<Vent_Line>& vent_lines, std::array<std::array<int, ARRSIZE>, ARRSIZE>& diagram);
-int count_overlaps(const std::array<std::array<int, ARRSIZE>, ARRSIZE>& diagram);
\ No newline at end of file
+std::vector<Vent_Line> load_vent_lines(std::span<const std::string_view> data);
+// True if the diagram for these lines stays within MAX_VENT_DIAGRAM_CELLS; count_overlaps_analytic
+// answers both parts without a diagram otherwise.
+bool vent_diagram_fits(const std::vector<Vent_Line>& vent_lines);
+void draw_straight_lines(const std::vector<Vent_Line>& vent_lines, Vent_Diagram& diagram);
+void draw_diagonal_lines(const std::vector<Vent_Line>& vent_lines, Vent_Diagram& diagram);
+// Recount the overlap points with a scan over all cells (diagram.overlaps holds the same number).
+int count_overlaps(const Vent_Diagram& diagram);
+// Multi-threaded versions of the two drawing functions. The diagram is cut into TILESIZE x TILESIZE
+// tiles, every line is binned into the tiles it crosses and the tiles are drawn by 'thread_count'
+// threads (0 = one per hardware thread) without any atomics, as no two threads share a tile.
+// Every tile tallies its own new overlaps; the functions return the updated diagram.overlaps.
+constexpr int TILESIZE {256};
+long long draw_straight_lines_tiled(const std::vector<Vent_Line>& vent_lines, Vent_Diagram& diagram, unsigned thread_count = 0);
+long long draw_diagonal_lines_tiled(const std::vector<Vent_Line>& vent_lines, Vent_Diagram& diagram, unsigned thread_count = 0);
+// Both answers with reading and parsing overlapped (see load_pipeline.hpp), threads as in
+// calculate_bingo_scores_pipelined; the lines are drawn tile by tile once all of them are parsed, or
+// counted with count_overlaps_analytic if their diagram would not fit. Throws std::runtime_error if the file cannot be read or holds a malformed line.
+struct Vent_Overlaps{
+	size_t line_count {0};
+	long long straight {0};
+	long long all {0};
+};
+Vent_Overlaps calculate_vent_overlaps_pipelined(const std::string& filename, unsigned thread_count = 0);
+// Count the same overlap points without rasterizing anything. The lines are grouped by orientation
+// and by the line they lie on (column, row, x - y or x + y); collinear overlaps are found with an
+// interval sweep per group and crossings between orientations are collected in a hash set. The cost
+// depends on the number of lines, not on the coordinate range.
+long long count_overlaps_analytic(const std::vector<Vent_Line>& vent_lines, bool include_diagonals);
\ No newline at end of file